@@ -1,5 +1,10 @@
 #include "app.h"
 
+#include <QCoreApplication>
+#include <QDir>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrentRun>
+
 
 
 App::App(QObject *parent) : QObject(parent)
@@ -9,9 +14,34 @@ App::App(QObject *parent) : QObject(parent)
 
     counter = 0;
 
+    QQmlObjectListModel<MySubmodel>::setPoolCapacity(256); // shared by all the pages
+
     testModel = new QQmlObjectListModel<MyModel>(this, "name", "name");
+    testModel->addIndex("mainID", true);
+
+    pageTree = NULL;
+    if (QCoreApplication::arguments().contains("--tree")) {
+        // pages and their sub-items in a single model, instead of one submodel per page
+        pageTree = new QQmlObjectTreeModel<MyModel, MySubmodel>(this);
+    }
+
+    if (QCoreApplication::arguments().contains("--replica")) {
+        // mirror the pages of another running instance, started with --publish
+        QQmlObjectListModelReplica *replica = new QQmlObjectListModelReplica(testModel, this);
+        replica->connectToPublisher("SubmodelInModel");
+    } else {
+        testModel->setJournalEnabled(true);
+    }
+    if (QCoreApplication::arguments().contains("--publish")) {
+        // let instances started with --replica mirror the pages
+        QQmlObjectListModelPublisher *publisher = new QQmlObjectListModelPublisher(testModel, this);
+        if (!publisher->listen("SubmodelInModel")) {
+            qWarning() << "Another instance already publishes its pages";
+        }
+    }
 
     engine.rootContext()->setContextProperty("testModel", testModel);
+    engine.rootContext()->setContextProperty("pageTree", pageTree);
     engine.rootContext()->setContextProperty("logic", this);
 
     engine.load(QUrl(QLatin1String("qrc:/main.qml")));
@@ -23,36 +53,58 @@ App::App(QObject *parent) : QObject(parent)
 }
 
 void App::btnClearAllPages(void) {
-    testModel->clear();
+    if (pageTree != NULL) {
+        pageTree->clear();
+    } else {
+        testModel->clear();
+    }
     counter = 0;
 }
 void App::btnClearListItems(int id) {
-    for (int z = 0; z<testModel->count(); z++) {
-        if (testModel->at(z)->get_mainID() == id) {
-            testModel->at(z)->submodel()->clear();
-        }
+    if (pageTree != NULL) {
+        pageTree->clearChildren(treeRow(id));
+        return;
+    }
+    MyModel *page = testModel->findItemBy("mainID", id);
+    if (page != NULL) {
+        page->submodel()->clear();
     }
 }
 
 void App::btnUpdateListItem(int id) {
-    for (int z = 0; z<testModel->count(); z++) {
-        if (testModel->at(z)->get_mainID() == id) {
-            if (testModel->at(z)->submodel()->count() > 2) {
-                // just update the second Item in the Submodel in case it exists:
-                testModel->at(z)->submodel()->at(1)->set_subname("Update TEST!");
-            }
+    if (pageTree != NULL) {
+        const int row = treeRow(id);
+        if (pageTree->childCount(row) > 2) {
+            pageTree->child(row, 1)->set_subname("Update TEST!");
+        }
+        return;
+    }
+    MyModel *page = testModel->findItemBy("mainID", id);
+    if (page != NULL) {
+        if (page->submodel()->count() > 2) {
+            // just update the second Item in the Submodel in case it exists:
+            page->submodel()->at(1)->set_subname("Update TEST!");
         }
     }
 }
 
 void App::btnAddListItem(int id) {
-    for (int z = 0; z<testModel->count(); z++) {
-        if (testModel->at(z)->get_mainID() == id) {
+    if (pageTree != NULL) {
+        const int row = treeRow(id);
+        if (row >= 0) {
             MySubmodel *sub = new MySubmodel();
-            sub->set_subid(testModel->at(z)->submodel()->count() + 1);
-            sub->set_subname("SubName " + QString::number(testModel->at(z)->submodel()->count()));
-            testModel->at(z)->submodel()->append(sub);
+            sub->set_subid(pageTree->childCount(row) + 1);
+            sub->set_subname("SubName " + QString::number(pageTree->childCount(row)));
+            pageTree->appendChild(row, sub);
         }
+        return;
+    }
+    MyModel *page = testModel->findItemBy("mainID", id);
+    if (page != NULL) {
+        MySubmodel *sub = page->submodel()->acquire();
+        sub->set_subid(page->submodel()->count() + 1);
+        sub->set_subname("SubName " + QString::number(page->submodel()->count()));
+        page->submodel()->append(sub);
     }
 }
 
@@ -62,7 +114,95 @@ void App::btnAddPage() {
     d->set_no(counter + 1);
     d->set_name("Page " + QString::number(counter + 1));
     d->set_remark("Remark text.");
+    if (pageTree != NULL) {
+        pageTree->appendPage(d);
+    } else {
+        testModel->append(d);
+    }
+
+    counter++;
+}
+
+void App::btnAddLazyPage(int itemCount) {
+    // the sub-items are only created when the ListView of the page scrolls to them
+    MyModel *d = new MyModel(this);
+    d->set_mainID(counter);
+    d->set_no(counter + 1);
+    d->set_name("Page " + QString::number(counter + 1));
+    d->set_remark("Lazy page.");
+    d->submodel()->setPageSource(QSharedPointer<MySubmodelSource>::create(itemCount));
     testModel->append(d);
 
     counter++;
 }
+
+void App::btnAddPagesAsync(int pageCount, int itemCount) {
+    // build the pages and their submodels in a worker thread, the GUI thread only gets the final insertion
+    const int first = counter;
+    counter += pageCount;
+    QQmlObjectListModel<MyModel> *model = testModel;
+    QtConcurrent::run([model, first, pageCount, itemCount]() {
+        QList<MyModel *> pages;
+        pages.reserve(pageCount);
+        for (int p = first; p < first + pageCount; p++) {
+            MyModel *d = new MyModel();
+            d->set_mainID(p);
+            d->set_no(p + 1);
+            d->set_name("Page " + QString::number(p + 1));
+            d->set_remark("Remark text.");
+            QList<MySubmodel *> subs;
+            subs.reserve(itemCount);
+            for (int i = 0; i < itemCount; i++) {
+                MySubmodel *sub = new MySubmodel();
+                sub->set_subid(i + 1);
+                sub->set_subname("SubName " + QString::number(i));
+                subs.append(sub);
+            }
+            d->submodel()->append(subs);
+            pages.append(d);
+        }
+        model->postAppend(pages);
+    });
+}
+
+int App::treeRow(int id) const {
+    for (int row = 0; row < pageTree->count(); row++) {
+        if (pageTree->page(row)->get_mainID() == id) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+QString App::dataPath(const QString &fileName) const {
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    QDir().mkpath(dir);
+    return dir + "/" + fileName;
+}
+
+void App::btnSaveSnapshot(void) {
+    if (!testModel->saveSnapshot(dataPath("pages.snapshot"))) {
+        qWarning() << "Can't save snapshot to" << dataPath("pages.snapshot");
+    }
+}
+
+void App::btnLoadSnapshot(void) {
+    // the submodels are only decoded when their ListView shows them
+    if (testModel->loadSnapshot(dataPath("pages.snapshot"), true)) {
+        counter = 0;
+        for (int i = 0; i < testModel->count(); i++) {
+            counter = qMax(counter, testModel->at(i)->get_mainID() + 1);
+        }
+    } else {
+        qWarning() << "Can't load snapshot from" << dataPath("pages.snapshot");
+    }
+}
+
+void App::btnImportJson(void) {
+    // parse in a worker thread, the pages are handed over to the GUI thread by batches
+    QQmlObjectListModel<MyModel> *model = testModel;
+    const QString path = dataPath("pages.json");
+    QtConcurrent::run([model, path]() {
+        model->importJsonFile(path, 100);
+    });
+}
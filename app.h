@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QQmlApplicationEngine>
 #include "qqmlobjectlistmodel.h"
+#include "qqmlobjectlistmodelreplication.h"
+#include "qqmlobjecttreemodel.h"
 #include "qqmlhelpers.h"
 #include <QtQml/QQmlContext>
 #include <QDateTime>
@@ -11,6 +13,7 @@
 class MySubmodel : public QObject {
 
     Q_OBJECT
+    QML_OBSERVABLE
 
     QML_WRITABLE_PROPERTY (int,          subid)
     QML_WRITABLE_PROPERTY (QString,      subname)
@@ -21,9 +24,35 @@ public:
     }
 };
 
+class MySubmodelSource : public QQmlObjectListModelSource<MySubmodel> {
+
+public:
+    explicit MySubmodelSource (int total) : m_next (0), m_total (total) { }
+
+    bool hasMore (void) const {
+        return m_next < m_total;
+    }
+
+    QList<MySubmodel *> fetch (int count) {
+        QList<MySubmodel *> ret;
+        for (; count > 0 && m_next < m_total; count--, m_next++) {
+            MySubmodel * sub = new MySubmodel ();
+            sub->set_subid (m_next + 1);
+            sub->set_subname ("SubName " + QString::number (m_next));
+            ret.append (sub);
+        }
+        return ret;
+    }
+
+private:
+    int m_next;
+    int m_total;
+};
+
 class MyModel : public QObject {
 
     Q_OBJECT
+    QML_OBSERVABLE
 
     QML_WRITABLE_PROPERTY (int,          mainID)
     QML_WRITABLE_PROPERTY (int,          no)
@@ -35,12 +64,16 @@ class MyModel : public QObject {
 public:
     explicit MyModel (QObject * parent = NULL) : QObject (parent) {        
         m_mainID  = -1;
-        m_submodel = new QQmlObjectListModel<MySubmodel>(this, "subname", "subname");
+        m_submodel = NULL;
     }
 
 public:
 
     QQmlObjectListModel<MySubmodel>* submodel() {
+        if (m_submodel == NULL) {
+            // created on first use, the pages of the tree model never need one
+            m_submodel = new QQmlObjectListModel<MySubmodel>(this, "subname", "subname");
+        }
         return m_submodel;
     }
 
@@ -61,14 +94,23 @@ signals:
 public slots:
 
     void btnAddPage(void);
+    void btnAddPagesAsync(int pageCount, int itemCount);
+    void btnAddLazyPage(int itemCount);
     void btnClearAllPages(void);
     void btnAddListItem(int id);
     void btnUpdateListItem(int id);    
     void btnClearListItems(int id);
+    void btnSaveSnapshot(void);
+    void btnLoadSnapshot(void);
+    void btnImportJson(void);
 
 private:
+    QString dataPath(const QString &fileName) const;
+    int treeRow(int id) const;
+
     QQmlApplicationEngine engine;
     QQmlObjectListModel<MyModel> *testModel;
+    QQmlObjectTreeModel<MyModel, MySubmodel> *pageTree;
 
     int counter;
 };
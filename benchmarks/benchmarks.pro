@@ -0,0 +1,23 @@
+TARGET = tst_bench_models
+
+QT += testlib network
+QT -= gui
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += ..
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += tst_bench_models.cpp
+
+HEADERS += \
+    ../qqmlgadgetlistmodel.h \
+    ../qqmlobjectlistmodel.h \
+    ../qqmlobjectlistmodelreplication.h \
+    ../qqmlobjectlistmodelstats.h \
+    ../qqmlobjecttreemodel.h \
+    ../qqmljsonstreamreader.h \
+    ../qqmlmpscqueue.h \
+    ../qqmlhelpers.h
@@ -0,0 +1,465 @@
+#include <QCoreApplication>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+#include <QtTest>
+
+#include "qqmlhelpers.h"
+#include "qqmlgadgetlistmodel.h"
+#include "qqmlobjectlistmodel.h"
+#include "qqmlobjectlistmodelreplication.h"
+#include "qqmlobjecttreemodel.h"
+
+#ifdef __GLIBC__
+#   include <malloc.h>
+#endif
+
+class BenchItem : public QObject {
+    Q_OBJECT
+    QML_OBSERVABLE
+
+    QML_WRITABLE_PROPERTY (int,     value)
+    QML_WRITABLE_PROPERTY (QString, key)
+
+public:
+    explicit BenchItem (QObject * parent = Q_NULLPTR) : QObject (parent) {
+        m_value = 0;
+    }
+};
+
+struct BenchValue { // NOTE : the same properties as BenchItem, stored by value
+    Q_GADGET
+
+    Q_PROPERTY (int     value MEMBER value)
+    Q_PROPERTY (QString key   MEMBER key)
+
+public:
+    BenchValue (void) : value (0) { }
+
+    int     value;
+    QString key;
+};
+
+class BenchPage : public QObject {
+    Q_OBJECT
+    QML_OBSERVABLE
+
+    QML_WRITABLE_PROPERTY (QString, name)
+
+    Q_PROPERTY (QQmlObjectListModelBase * submodel READ submodel CONSTANT)
+
+public:
+    explicit BenchPage (QObject * parent = Q_NULLPTR)
+        : QObject (parent)
+        , m_submodel (new QQmlObjectListModel<BenchItem> (this, QByteArray (), "key"))
+    { }
+
+    QQmlObjectListModelBase * submodel (void) const {
+        return m_submodel;
+    }
+
+private:
+    QQmlObjectListModel<BenchItem> * m_submodel;
+};
+
+/*!
+    \details Measures the list model paths listed in the "Performance" table of the README,
+    each one at 1k, 100k and 1M rows.
+
+    The structural changes are measured once per row count (they consume their input), the
+    read-only and property paths are repeated by QBENCHMARK until the timing is stable.
+    Run it with \c -callgrind or \c -perf (Linux) for instruction counts instead of wall time.
+*/
+class TestBenchModels : public QObject {
+    Q_OBJECT
+
+private: // helpers
+    static QList<BenchItem *> makeItems (int count, int offset = 0) {
+        QList<BenchItem *> ret;
+        ret.reserve (count);
+        for (int idx = 0; idx < count; idx++) {
+            BenchItem * item = new BenchItem;
+            item->set_value (offset + idx);
+            item->set_key (QString::number (offset + idx));
+            ret.append (item);
+        }
+        return ret;
+    }
+    static void addRowCounts (void) {
+        QTest::addColumn<int> ("rows");
+        QTest::newRow ("1k")   << 1000;
+        QTest::newRow ("100k") << 100000;
+        QTest::newRow ("1M")   << 1000000;
+    }
+    static void addDispatchRows (void) { // NOTE : "by name" is the path data() and setData() took before the role table
+        QTest::addColumn<int>  ("rows");
+        QTest::addColumn<bool> ("byName");
+        QTest::newRow ("1k role table")     << 1000    << false;
+        QTest::newRow ("1k by name")        << 1000    << true;
+        QTest::newRow ("100k role table")   << 100000  << false;
+        QTest::newRow ("100k by name")      << 100000  << true;
+        QTest::newRow ("1M role table")     << 1000000 << false;
+        QTest::newRow ("1M by name")        << 1000000 << true;
+    }
+    static void addPoolRows (void) {
+        QTest::addColumn<int>  ("rows");
+        QTest::addColumn<bool> ("pooled");
+        QTest::newRow ("1k new/delete")   << 1000    << false;
+        QTest::newRow ("1k pooled")       << 1000    << true;
+        QTest::newRow ("100k new/delete") << 100000  << false;
+        QTest::newRow ("100k pooled")     << 100000  << true;
+        QTest::newRow ("1M new/delete")   << 1000000 << false;
+        QTest::newRow ("1M pooled")       << 1000000 << true;
+    }
+    static void addStorageRows (void) {
+        QTest::addColumn<int>  ("rows");
+        QTest::addColumn<bool> ("gadget");
+        QTest::newRow ("1k object")   << 1000    << false;
+        QTest::newRow ("1k gadget")   << 1000    << true;
+        QTest::newRow ("100k object") << 100000  << false;
+        QTest::newRow ("100k gadget") << 100000  << true;
+        QTest::newRow ("1M object")   << 1000000 << false;
+        QTest::newRow ("1M gadget")   << 1000000 << true;
+    }
+    static QAbstractListModel * makeStorageModel (int rows, bool gadget) {
+        if (gadget) {
+            QQmlGadgetListModel<BenchValue> * ret = new QQmlGadgetListModel<BenchValue> (Q_NULLPTR, "key");
+            QVector<BenchValue> values (rows);
+            for (int idx = 0; idx < rows; idx++) {
+                values [idx].value = idx;
+                values [idx].key   = QString::number (idx);
+            }
+            ret->append (values);
+            return ret;
+        }
+        else {
+            QQmlObjectListModel<BenchItem> * ret = new QQmlObjectListModel<BenchItem> (Q_NULLPTR, "key");
+            ret->append (makeItems (rows));
+            return ret;
+        }
+    }
+#ifdef __GLIBC__
+    static qint64 heapBytes (void) { // NOTE : bytes in use in the malloc heap, mmapped blocks included
+#   if __GLIBC_PREREQ (2, 33)
+        const struct mallinfo2 info = mallinfo2 ();
+#   else
+        const struct mallinfo info = mallinfo ();
+#   endif
+        return (qint64 (info.uordblks) + qint64 (info.hblkhd));
+    }
+#endif
+    static QString publisherName (void) { // NOTE : one local socket per test process
+        return (QStringLiteral ("tst_bench_models-") % QString::number (QCoreApplication::applicationPid ()));
+    }
+    static void flushRelease (QObject * model) { // NOTE : removed items are released on next event-loop iteration
+        QCoreApplication::sendPostedEvents (model, QEvent::MetaCall);
+    }
+
+private slots:
+    void appendList_data (void) { addRowCounts (); }
+    void appendList (void) {
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchItem> model;
+        const QList<BenchItem *> items = makeItems (rows);
+        QBENCHMARK_ONCE {
+            model.append (items);
+        }
+        QCOMPARE (model.count (), rows);
+    }
+
+    void appendOne_data (void) { addRowCounts (); }
+    void appendOne (void) {
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchItem> model;
+        const QList<BenchItem *> items = makeItems (rows);
+        QBENCHMARK_ONCE {
+            for (int idx = 0; idx < rows; idx++) {
+                model.append (items.at (idx));
+            }
+        }
+        QCOMPARE (model.count (), rows);
+    }
+
+    void prependOne_data (void) { addRowCounts (); }
+    void prependOne (void) {
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchItem> model;
+        const QList<BenchItem *> items = makeItems (rows);
+        QBENCHMARK_ONCE {
+            for (int idx = 0; idx < rows; idx++) {
+                model.prepend (items.at (idx));
+            }
+        }
+        QCOMPARE (model.indexOf (items.first ()), rows -1);
+    }
+
+    void insertList_data (void) { addRowCounts (); }
+    void insertList (void) {
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchItem> model;
+        model.append (makeItems (rows));
+        const QList<BenchItem *> items = makeItems (rows, rows);
+        QBENCHMARK_ONCE {
+            model.insert (rows / 2, items);
+        }
+        QCOMPARE (model.indexOf (items.first ()), rows / 2);
+    }
+
+    void data_data (void) { addDispatchRows (); }
+    void data (void) {
+        QFETCH (int, rows);
+        QFETCH (bool, byName);
+        QQmlObjectListModel<BenchItem> model;
+        model.append (makeItems (rows));
+        const int role = model.roleForName ("value");
+        const QHash<int, QByteArray> roles = model.roleNames ();
+        qint64 sum = 0;
+        if (byName) {
+            QBENCHMARK {
+                for (int row = 0; row < rows; row++) {
+                    sum += model.at (row)->property (roles.value (role)).toInt ();
+                }
+            }
+        }
+        else {
+            QBENCHMARK {
+                for (int row = 0; row < rows; row++) {
+                    sum += model.data (model.index (row), role).toInt ();
+                }
+            }
+        }
+        QVERIFY (sum > 0);
+    }
+
+    void setData_data (void) { addDispatchRows (); }
+    void setData (void) {
+        QFETCH (int, rows);
+        QFETCH (bool, byName);
+        QQmlObjectListModel<BenchItem> model;
+        model.append (makeItems (rows));
+        const int role = model.roleForName ("value");
+        const QHash<int, QByteArray> roles = model.roleNames ();
+        int pass = 0;
+        if (byName) {
+            QBENCHMARK {
+                pass++; // NOTE : a new value each time, so that every write notifies
+                for (int row = 0; row < rows; row++) {
+                    model.at (row)->setProperty (roles.value (role), -(row + pass));
+                }
+            }
+        }
+        else {
+            QBENCHMARK {
+                pass++;
+                for (int row = 0; row < rows; row++) {
+                    model.setData (model.index (row), -(row + pass), role);
+                }
+            }
+        }
+        QCOMPARE (model.at (0)->get_value (), -pass);
+    }
+
+    void propertyChange_data (void) { addRowCounts (); }
+    void propertyChange (void) {
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchItem> model;
+        const QList<BenchItem *> items = makeItems (rows);
+        model.append (items);
+        int changes = 0;
+        connect (&model, &QAbstractItemModel::dataChanged, [&changes] (void) { changes++; });
+        QBENCHMARK {
+            for (int idx = 0; idx < rows; idx++) {
+                BenchItem * item = items.at (idx);
+                item->set_value (item->get_value () +1);
+            }
+        }
+        QVERIFY (changes >= rows);
+    }
+
+    void clear_data (void) { addRowCounts (); }
+    void clear (void) {
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchItem> model;
+        model.append (makeItems (rows));
+        QBENCHMARK_ONCE {
+            model.clear ();
+            flushRelease (&model);
+        }
+        QCOMPARE (model.count (), 0);
+    }
+
+    void uidLookup_data (void) { addRowCounts (); }
+    void uidLookup (void) {
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchItem> model (Q_NULLPTR, QByteArray (), "key");
+        model.append (makeItems (rows));
+        QStringList keys;
+        keys.reserve (rows);
+        for (int idx = 0; idx < rows; idx++) {
+            keys.append (QString::number (rows -1 - idx));
+        }
+        int found = 0;
+        QBENCHMARK {
+            found = 0;
+            for (int idx = 0; idx < rows; idx++) {
+                found += (model.getByUid (keys.at (idx)) != Q_NULLPTR);
+            }
+        }
+        QCOMPARE (found, rows);
+    }
+
+    void uidAppendClear_data (void) { addRowCounts (); }
+    void uidAppendClear (void) { // NOTE : quadratic when the UID index is scanned to find the key of an item
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchItem> model (Q_NULLPTR, QByteArray (), "key");
+        const QList<BenchItem *> items = makeItems (rows);
+        QBENCHMARK_ONCE {
+            for (int idx = 0; idx < rows; idx++) {
+                model.append (items.at (idx));
+            }
+            model.clear ();
+            flushRelease (&model);
+        }
+        QCOMPARE (model.getByUid (QStringLiteral ("0")), static_cast<BenchItem *> (Q_NULLPTR));
+    }
+
+    void churn_data (void) { addPoolRows (); }
+    void churn (void) { // NOTE : a list refilled over and over, as when a view reloads its content
+        QFETCH (int, rows);
+        QFETCH (bool, pooled);
+        static const int ROUNDS = 5;
+        QQmlObjectListModel<BenchItem>::setPoolCapacity (pooled ? rows : 0);
+        QQmlObjectListModel<BenchItem> model;
+        QBENCHMARK_ONCE {
+            for (int round = 0; round < ROUNDS; round++) {
+                QList<BenchItem *> items;
+                items.reserve (rows);
+                for (int idx = 0; idx < rows; idx++) {
+                    BenchItem * item = model.acquire ();
+                    item->set_value (idx);
+                    items.append (item);
+                }
+                model.append (items);
+                model.clear ();
+                flushRelease (&model);
+            }
+        }
+        QCOMPARE (QQmlObjectListModel<BenchItem>::pooledCount (), (pooled ? rows : 0));
+        QQmlObjectListModel<BenchItem>::setPoolCapacity (0); // NOTE : the pool is shared, don't leak it into the other benchmarks
+    }
+
+    void nestedConstruction_data (void) { addRowCounts (); }
+    void nestedConstruction (void) {
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchPage> model (Q_NULLPTR, "name");
+        QBENCHMARK_ONCE {
+            QList<BenchPage *> pages;
+            pages.reserve (rows);
+            for (int idx = 0; idx < rows; idx++) {
+                BenchPage * page = new BenchPage;
+                page->set_name (QString::number (idx));
+                pages.append (page);
+            }
+            model.append (pages);
+        }
+        QCOMPARE (model.count (), rows);
+    }
+
+    void storage_data (void) { addStorageRows (); }
+    void storage (void) { // NOTE : filling the model, then one data() pass over all the rows
+        QFETCH (int,  rows);
+        QFETCH (bool, gadget);
+        QScopedPointer<QAbstractListModel> model;
+        int sum = 0;
+        QBENCHMARK_ONCE {
+            model.reset (makeStorageModel (rows, gadget));
+            const int role = model->roleNames ().key ("value");
+            for (int row = 0; row < rows; row++) {
+                sum += model->data (model->index (row), role).toInt ();
+            }
+        }
+        QCOMPARE (model->rowCount (), rows);
+        QCOMPARE (model->data (model->index (rows -1), Qt::DisplayRole).toString (), QString::number (rows -1));
+        QVERIFY (sum != 0);
+    }
+
+    void storageBytes_data (void) { addStorageRows (); }
+    void storageBytes (void) { // NOTE : heap held by the rows, reported as the benchmark result
+#ifdef __GLIBC__
+        QFETCH (int,  rows);
+        QFETCH (bool, gadget);
+        const qint64 before = heapBytes ();
+        QScopedPointer<QAbstractListModel> model (makeStorageModel (rows, gadget));
+        QTest::setBenchmarkResult (qreal (heapBytes () - before), QTest::BytesAllocated);
+        QCOMPARE (model->rowCount (), rows);
+#else
+        QSKIP ("the heap usage is only read from glibc");
+#endif
+    }
+
+    void replicationUpdates_data (void) { addRowCounts (); }
+    void replicationUpdates (void) { // NOTE : every row changed once, until the replica in the same process has them all
+        QFETCH (int, rows);
+        QQmlObjectListModel<BenchItem> model;
+        QQmlObjectListModel<BenchItem> mirror;
+        model.append (makeItems (rows));
+        QQmlObjectListModelPublisher publisher (&model);
+        QQmlObjectListModelReplica replica (&mirror);
+        QVERIFY (publisher.listen (publisherName ()));
+        replica.connectToPublisher (publisherName ());
+        QTRY_COMPARE_WITH_TIMEOUT (mirror.count (), rows, 60000);
+        QBENCHMARK_ONCE {
+            for (int row = 0; row < rows; row++) {
+                model.at (row)->set_value (rows + row);
+            }
+            QTRY_COMPARE_WITH_TIMEOUT (mirror.at (rows -1)->get_value (), (rows + rows -1), 60000); // NOTE : a frame is applied as a whole
+        }
+        QCOMPARE (mirror.at (0)->get_value (), rows);
+    }
+
+    void replicationLatency (void) { // NOTE : one property change, until the replica in the same process has it
+        QQmlObjectListModel<BenchItem> model;
+        QQmlObjectListModel<BenchItem> mirror;
+        model.append (makeItems (1000));
+        QQmlObjectListModelPublisher publisher (&model);
+        QQmlObjectListModelReplica replica (&mirror);
+        QVERIFY (publisher.listen (publisherName ()));
+        replica.connectToPublisher (publisherName ());
+        QTRY_COMPARE (mirror.count (), model.count ());
+        BenchItem * source = model.at (500);
+        BenchItem * target = mirror.at (500);
+        int value = source->get_value ();
+        QElapsedTimer timer;
+        timer.start ();
+        QBENCHMARK {
+            source->set_value (++value);
+            while (target->get_value () != value) {
+                QCoreApplication::processEvents ();
+                QVERIFY (timer.elapsed () < 60000);
+            }
+        }
+    }
+
+    void treeInsertRows (void) { // NOTE : not timed, checks the lazy row indexes of the tree after an insertion at the top
+        QQmlObjectTreeModel<BenchPage, BenchItem> tree;
+        for (int row = 0; row < 3; row++) {
+            tree.appendPage (new BenchPage);
+            tree.appendChild (0, new BenchItem);
+        }
+        QCOMPARE (tree.indexOfPage (tree.page (2)), 2); // NOTE : all the rows are numbered before the insertion
+        QCOMPARE (tree.indexOfChild (tree.child (0, 2)), 2);
+        tree.insertPage (0, new BenchPage);
+        tree.insertChild (1, 0, new BenchItem);
+        for (int row = 0; row < tree.count (); row++) {
+            QCOMPARE (tree.indexOfPage (tree.page (row)), row);
+        }
+        for (int childRow = 0; childRow < tree.childCount (1); childRow++) {
+            QCOMPARE (tree.indexOfChild (tree.child (1, childRow)), childRow);
+            QCOMPARE (tree.parent (tree.index (childRow, 0, tree.pageIndex (1))), tree.pageIndex (1));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN (TestBenchModels)
+
+#include "tst_bench_models.moc"
@@ -3,6 +3,7 @@ import QtQuick.Layouts 1.3
 import QtQuick.Controls 2.2
 import QtQuick.Controls.Material 2.2
 import QtQuick.Window 2.3
+import QtQml.Models 2.2
 
 ApplicationWindow {
     visible: true
@@ -29,6 +30,20 @@ ApplicationWindow {
                                 logic.btnAddPage();
                             }
                         }
+                        Button {
+                            text: "add 10 Pages (async)"
+                            enabled: !pageTree // the tree model only covers the basic edits
+                            onClicked: {
+                                logic.btnAddPagesAsync(10, 1000);
+                            }
+                        }
+                        Button {
+                            text: "add lazy Page"
+                            enabled: !pageTree
+                            onClicked: {
+                                logic.btnAddLazyPage(100000);
+                            }
+                        }
                         Button {
                             text: "remove all Pages"
                             onClicked: {
@@ -36,13 +51,50 @@ ApplicationWindow {
                             }
                         }
                     }
+                    RowLayout {
+                        Button {
+                            text: "save Snapshot"
+                            enabled: !pageTree
+                            onClicked: {
+                                logic.btnSaveSnapshot();
+                            }
+                        }
+                        Button {
+                            text: "load Snapshot"
+                            enabled: !pageTree
+                            onClicked: {
+                                logic.btnLoadSnapshot();
+                            }
+                        }
+                        Button {
+                            text: "import JSON"
+                            enabled: !pageTree
+                            onClicked: {
+                                logic.btnImportJson();
+                            }
+                        }
+                        Button {
+                            text: "undo"
+                            enabled: !pageTree && testModel.canUndo
+                            onClicked: {
+                                testModel.undo();
+                            }
+                        }
+                        Button {
+                            text: "redo"
+                            enabled: !pageTree && testModel.canRedo
+                            onClicked: {
+                                testModel.redo();
+                            }
+                        }
+                    }
                 }
             }
         }
 
         Repeater {
             id: rep
-            model: testModel
+            model: pageTree ? pageTree : testModel
             // model: 5
             Page {
                 id: page
@@ -88,17 +140,10 @@ ApplicationWindow {
                             }
                         }
 
-                        ListView {
-                            id: listViewSubModel
-                            clip: true
-                            Layout.fillHeight: true
-                            Layout.fillWidth: true
-                            model: submodel
-                            // model: 10
-                            orientation: ListView.Vertical
-                            delegate:
-                                Frame {
-                                width: parent.width
+                        Component {
+                            id: subDelegate
+                            Frame {
+                                width: listViewSubModel.width
                                 height: 40
                                 Item {
                                     anchors.fill: parent
@@ -109,6 +154,25 @@ ApplicationWindow {
                                 }
                             }
                         }
+
+                        DelegateModel {
+                            // with --tree, the children of this page in the single tree model
+                            id: pageItems
+                            model: pageTree
+                            rootIndex: pageTree ? pageTree.pageIndex(index) : null
+                            delegate: subDelegate
+                        }
+
+                        ListView {
+                            id: listViewSubModel
+                            clip: true
+                            Layout.fillHeight: true
+                            Layout.fillWidth: true
+                            model: pageTree ? pageItems : submodel
+                            // model: 10
+                            orientation: ListView.Vertical
+                            delegate: subDelegate
+                        }
                     }
                 }
             }
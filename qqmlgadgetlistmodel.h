@@ -0,0 +1,339 @@
+#ifndef QQMLGADGETLISTMODEL_H
+#define QQMLGADGETLISTMODEL_H
+
+/*!
+    \class QQmlGadgetListModel
+
+    \ingroup QT_QML_MODELS
+
+    \brief Provides a generic list model storing Q_GADGET values contiguously, suitable for QML
+
+    QQmlGadgetListModel is the value-type sibling of QQmlObjectListModel : it extracts the
+    properties of a \c Q_GADGET class (or struct) with Qt Meta Object and creates according
+    roles inside the model, but the items are stored by value in a single \c QVector instead
+    of being heap-allocated \c QObject instances.
+
+    A row then costs the size of the struct, without d-pointer, parent / children bookkeeping
+    or signal connections, and iterating over the model walks contiguous memory.
+
+    The roles come from the same shared per-type role table as QQmlObjectListModel, built once
+    per item type and display role (see \c QQmlObjectRoleTable).
+
+    Since values have no notify signal, the model can't detect changes made behind its back :
+    all the modifications go through its API (setData(), update(), modify(), append(), ...),
+    which emits the according \c dataChanged() or row signals.
+
+    Example of item type :
+    \code
+        struct MySubitem {
+            Q_GADGET
+            Q_PROPERTY (int     subid   MEMBER subid)
+            Q_PROPERTY (QString subname MEMBER subname)
+        public:
+            int     subid;
+            QString subname;
+        };
+    \endcode
+
+    \b Note : The item type needs to be default-constructible, copyable, and a \c Q_GADGET.
+
+    \sa QQmlObjectListModel
+*/
+
+/*!
+    \fn void QQmlGadgetListModel::update (int idx, const ItemType & item)
+
+    \details Replaces the value of an item, and notifies the roles that really changed.
+
+    \param idx The position of the item in the model
+    \param item The new value
+*/
+
+/*!
+    \fn void QQmlGadgetListModel::modify (int idx, Func func)
+
+    \details Modifies an item in place with a callable taking a \c {ItemType&},
+    then notifies the whole row as changed.
+
+    \param idx The position of the item in the model
+    \param func The callable doing the modification
+*/
+
+/*!
+    \details Returns the values of all the roles of an item, for QML.
+
+    \param idx The position of the item in the model
+    \return A map of role name to value, empty if the position is invalid
+*/
+
+/*!
+    \details Modifies a single property of an item, for QML.
+
+    \param idx The position of the item in the model
+    \param name The name of the property / role
+    \param value The data to write
+    \return Weither the modification was done
+*/
+
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QHash>
+#include <QMetaProperty>
+#include <QVariant>
+#include <QVariantMap>
+#include <QVector>
+
+#include <algorithm>
+
+#include "qqmlobjectlistmodel.h"
+
+class QQmlGadgetListModelBase : public QAbstractListModel { // abstract Qt base class
+    Q_OBJECT
+    Q_PROPERTY (int count READ count NOTIFY countChanged)
+
+public:
+    explicit QQmlGadgetListModelBase (QObject * parent = Q_NULLPTR) : QAbstractListModel (parent) { }
+
+public slots: // virtual methods API for QML
+    virtual int size (void) const = 0;
+    virtual int count (void) const = 0;
+    virtual bool isEmpty (void) const = 0;
+    virtual int roleForName (const QByteArray & name) const = 0;
+    virtual void clear (void) = 0;
+    virtual void move (int idx, int pos) = 0;
+    virtual void remove (int idx) = 0;
+    virtual void removeRange (int idx, int count) = 0;
+    virtual QVariantMap get (int idx) const = 0;
+    virtual bool setProperty (int idx, const QString & name, const QVariant & value) = 0;
+
+signals: // notifier
+    void countChanged (void);
+};
+
+template<class ItemType> class QQmlGadgetListModel : public QQmlGadgetListModelBase {
+    typedef QQmlObjectRoleTable<ItemType> RoleTable; // shared per-type role metadata
+
+public:
+    explicit QQmlGadgetListModel (QObject * parent = Q_NULLPTR, const QByteArray & displayRole = QByteArray ())
+        : QQmlGadgetListModelBase (parent)
+        , m_meta (RoleTable::get (displayRole, QByteArray ()))
+        , m_roles (m_meta->roles)
+        , m_dispRole (m_meta->dispRole)
+    {
+        m_roles.remove (baseRole ()); // NOTE : values have no object to expose as "qtObject"
+    }
+    bool setData (const QModelIndex & index, const QVariant & value, int role) Q_DECL_FINAL {
+        bool ret = false;
+        const int row = index.row ();
+        const QMetaProperty & metaProp = propertyForRole (role);
+        if (row >= 0 && row < m_items.count () && metaProp.isValid ()) {
+            if (metaProp.readOnGadget (&m_items.at (row)) != value) {
+                ret = metaProp.writeOnGadget (&m_items [row], value);
+                if (ret) {
+                    notifyRoleChanged (row, (role != Qt::DisplayRole ? role : m_dispRole));
+                }
+            }
+        }
+        return ret;
+    }
+    QVariant data (const QModelIndex & index, int role) const Q_DECL_FINAL {
+        QVariant ret;
+        const int row = index.row ();
+        const QMetaProperty & metaProp = propertyForRole (role);
+        if (row >= 0 && row < m_items.count () && metaProp.isValid ()) {
+            ret = metaProp.readOnGadget (&m_items.at (row));
+        }
+        return ret;
+    }
+    QHash<int, QByteArray> roleNames (void) const Q_DECL_FINAL {
+        return m_roles;
+    }
+    typedef typename QVector<ItemType>::const_iterator const_iterator;
+    const_iterator begin (void) const {
+        return m_items.begin ();
+    }
+    const_iterator end (void) const {
+        return m_items.end ();
+    }
+    const_iterator constBegin (void) const {
+        return m_items.constBegin ();
+    }
+    const_iterator constEnd (void) const {
+        return m_items.constEnd ();
+    }
+
+public: // C++ API
+    const ItemType & at (int idx) const {
+        return m_items.at (idx);
+    }
+    int roleForName (const QByteArray & name) const Q_DECL_FINAL {
+        return m_roles.key (name, -1);
+    }
+    int count (void) const Q_DECL_FINAL {
+        return m_items.count ();
+    }
+    int size (void) const Q_DECL_FINAL {
+        return m_items.count ();
+    }
+    bool isEmpty (void) const Q_DECL_FINAL {
+        return m_items.isEmpty ();
+    }
+    void reserve (int count) {
+        m_items.reserve (count);
+    }
+    void clear (void) Q_DECL_FINAL {
+        if (!m_items.isEmpty ()) {
+            beginRemoveRows (noParent (), 0, m_items.count () -1);
+            m_items.clear ();
+            endRemoveRows ();
+            emit countChanged ();
+        }
+    }
+    void append (const ItemType & item) {
+        insert (m_items.count (), item);
+    }
+    void prepend (const ItemType & item) {
+        insert (0, item);
+    }
+    void insert (int idx, const ItemType & item) {
+        if (idx >= 0 && idx <= m_items.count ()) {
+            beginInsertRows (noParent (), idx, idx);
+            m_items.insert (idx, item);
+            endInsertRows ();
+            emit countChanged ();
+        }
+    }
+    void append (const QVector<ItemType> & itemList) {
+        insert (m_items.count (), itemList);
+    }
+    void prepend (const QVector<ItemType> & itemList) {
+        insert (0, itemList);
+    }
+    void insert (int idx, const QVector<ItemType> & itemList) {
+        if (!itemList.isEmpty () && idx >= 0 && idx <= m_items.count ()) {
+            beginInsertRows (noParent (), idx, idx + itemList.count () -1);
+            if (idx == m_items.count ()) {
+                m_items.append (itemList);
+            }
+            else {
+                QVector<ItemType> items;
+                items.reserve (m_items.count () + itemList.count ());
+                items.append (m_items.mid (0, idx));
+                items.append (itemList);
+                items.append (m_items.mid (idx));
+                m_items.swap (items);
+            }
+            endInsertRows ();
+            emit countChanged ();
+        }
+    }
+    void move (int idx, int pos) Q_DECL_FINAL {
+        if (idx != pos && idx >= 0 && pos >= 0 && idx < m_items.count () && pos < m_items.count ()
+            && beginMoveRows (noParent (), idx, idx, noParent (), (idx < pos ? pos +1 : pos))) {
+            typename QVector<ItemType>::iterator first = m_items.begin ();
+            if (idx < pos) {
+                std::rotate (first + idx, first + idx +1, first + pos +1);
+            }
+            else {
+                std::rotate (first + pos, first + idx, first + idx +1);
+            }
+            endMoveRows ();
+        }
+    }
+    void remove (int idx) Q_DECL_FINAL {
+        removeRange (idx, 1);
+    }
+    void removeRange (int idx, int count) Q_DECL_FINAL {
+        if (idx >= 0 && idx < m_items.count () && count > 0) {
+            const int last = (qMin (idx + count, m_items.count ()) -1);
+            beginRemoveRows (noParent (), idx, last);
+            m_items.remove (idx, last - idx +1);
+            endRemoveRows ();
+            emit countChanged ();
+        }
+    }
+    void update (int idx, const ItemType & item) {
+        if (idx >= 0 && idx < m_items.count ()) {
+            QVector<int> rolesList;
+            for (int role = (baseRole () +1); role - baseRole () < m_meta->propByRole.count (); role++) {
+                const QMetaProperty & metaProp = m_meta->propByRole.at (role - baseRole ());
+                if (metaProp.isValid () && metaProp.readOnGadget (&m_items.at (idx)) != metaProp.readOnGadget (&item)) {
+                    rolesList.append (role);
+                    if (role == m_dispRole) {
+                        rolesList.append (Qt::DisplayRole);
+                    }
+                }
+            }
+            m_items [idx] = item;
+            if (!rolesList.isEmpty ()) {
+                const QModelIndex index = QAbstractListModel::index (idx, 0, noParent ());
+                emit dataChanged (index, index, rolesList);
+            }
+        }
+    }
+    template<typename Func> void modify (int idx, Func func) {
+        if (idx >= 0 && idx < m_items.count ()) {
+            func (m_items [idx]);
+            const QModelIndex index = QAbstractListModel::index (idx, 0, noParent ());
+            emit dataChanged (index, index);
+        }
+    }
+    const QVector<ItemType> & toVector (void) const {
+        return m_items;
+    }
+
+public: // QML slots implementation
+    QVariantMap get (int idx) const Q_DECL_FINAL {
+        QVariantMap ret;
+        if (idx >= 0 && idx < m_items.count ()) {
+            for (QHash<int, QByteArray>::const_iterator it = m_roles.constBegin (); it != m_roles.constEnd (); ++it) {
+                const QMetaProperty & metaProp = propertyForRole (it.key ());
+                if (metaProp.isValid ()) {
+                    ret.insert (QString::fromUtf8 (it.value ()), metaProp.readOnGadget (&m_items.at (idx)));
+                }
+            }
+        }
+        return ret;
+    }
+    bool setProperty (int idx, const QString & name, const QVariant & value) Q_DECL_FINAL {
+        return setData (QAbstractListModel::index (idx, 0, noParent ()), value, roleForName (name.toUtf8 ()));
+    }
+
+protected: // internal stuff
+    static const QModelIndex & noParent (void) {
+        static const QModelIndex ret = QModelIndex ();
+        return ret;
+    }
+    static int baseRole (void) {
+        return RoleTable::baseRole ();
+    }
+    int rowCount (const QModelIndex & parent = QModelIndex ()) const Q_DECL_FINAL {
+        return (!parent.isValid () ? m_items.count () : 0);
+    }
+    const QMetaProperty & propertyForRole (int role) const { // role -> property dispatch, no name lookup
+        static const QMetaProperty INVALID = QMetaProperty ();
+        const int idx = (role != Qt::DisplayRole ? role - baseRole () : -1);
+        if (idx > 0 && idx < m_meta->propByRole.count ()) {
+            return m_meta->propByRole.at (idx);
+        }
+        return (role == Qt::DisplayRole ? m_meta->dispProp : INVALID);
+    }
+    void notifyRoleChanged (int row, int role) {
+        QVector<int> rolesList;
+        rolesList.append (role);
+        if (role == m_dispRole) {
+            rolesList.append (Qt::DisplayRole);
+        }
+        const QModelIndex index = QAbstractListModel::index (row, 0, noParent ());
+        emit dataChanged (index, index, rolesList);
+    }
+
+private: // data members
+    const RoleTable *      m_meta;
+    QHash<int, QByteArray> m_roles;
+    int                    m_dispRole;
+    QVector<ItemType>      m_items;
+};
+
+#endif // QQMLGADGETLISTMODEL_H
@@ -25,6 +25,7 @@
         {type} get_{name} () const; // public getter method
         void set_{name} ({type}); // public setter slot
         void {name}Changed ({type}); // notifier signal
+        static const QQmlFieldDescriptor * qmlField (...); // compile-time accessors, see QQmlFieldDescriptor
     \endcode
 
     \b Note : Any change from either C++ or QML side will trigger the notification.
@@ -46,6 +47,7 @@
         {type} get_{name} () const; // public getter method
         void update_{name} ({type}); // public setter method
         void {name}Changed ({type}); // notifier signal
+        static const QQmlFieldDescriptor * qmlField (...); // compile-time accessors, see QQmlFieldDescriptor
     \endcode
 
     \b Note : Any change from C++ side will trigger the notification to QML.
@@ -71,6 +73,53 @@
 */
 
 
+/*!
+    \class QQmlFieldDescriptor
+    \ingroup QT_QML_HELPERS
+    \details Compile-time accessors of a property made by \c QML_WRITABLE_PROPERTY or \c QML_READONLY_PROPERTY.
+
+    Each of these macros also numbers its property in declaration order and adds a descriptor
+    for it, holding the index of its notifier signal and plain function pointers calling its
+    \c get_{name} / \c set_{name} methods directly. The descriptors of a class are listed by :
+    \code
+        QQmlFieldsOf<MyClass>::fields (); // QVector<const QQmlFieldDescriptor *>
+    \endcode
+
+    \c QQmlObjectListModel maps them to its roles through the notifier signal index, and uses them
+    instead of going through \c QMetaProperty, while the \c Q_PROPERTY declarations keep working as
+    before for QML. A null \c QVariant written through a descriptor resets the property to its
+    default-constructed value, the same as \c QMetaProperty::write.
+
+    \b Note : The properties a class inherits from a base class also using these macros, and the
+    ones declared with a plain \c Q_PROPERTY, keep going through \c QMetaProperty. A class can have
+    up to 128 of these properties.
+*/
+
+
+/*!
+    \def QML_OBSERVABLE
+    \ingroup QT_QML_HELPERS
+    \hideinitializer
+    \details Makes a class notify its property changes to a single observer, without signal connection.
+
+    It generates for this goal :
+    \code
+        QQmlItemObserver * m_qmlObserver; // private member variable
+        QQmlItemObserver * qmlObserver () const; // public getter method
+        void setQmlObserver (QQmlItemObserver *); // public setter method
+    \endcode
+
+    The setters made by \c QML_WRITABLE_PROPERTY and \c QML_READONLY_PROPERTY then call the observer
+    after emitting their notifier signal, with the index of that signal and the value it replaced
+    (boxed in a \c QVariant only if the observer asks for it). \c QQmlObjectListModel uses it
+    instead of connecting each notifier signal of each item it references, and its undo journal
+    takes the old values from it.
+
+    \b Note : All the notifying properties of the class must be made with these macros, otherwise
+    their changes won't reach the observer.
+*/
+
+
 /*!
     \def QML_ENUM_CLASS(name, ...)
     \ingroup QT_QML_HELPERS
@@ -95,7 +144,197 @@
 
 
 
+#include <QMetaMethod>
 #include <QObject>
+#include <QVariant>
+#include <QVector>
+
+#include <type_traits>
+#include <utility>
+
+class QQmlOldValue { // the value a setter just replaced, only boxed in a QVariant when asked for
+public:
+    template<typename T> explicit QQmlOldValue (const T & value) : m_data (&value), m_box (&box<T>) { }
+
+    QVariant toVariant (void) const {
+        return m_box (m_data);
+    }
+
+private:
+    template<typename T> static QVariant box (const void * data) {
+        return QVariant::fromValue (* static_cast<const T *> (data));
+    }
+
+    const void * m_data;
+    QVariant (* m_box) (const void * data);
+};
+
+class QQmlItemObserver { // single intrusive observer of an item, see QML_OBSERVABLE
+public:
+    virtual ~QQmlItemObserver (void) { }
+    virtual void itemPropertyChanged (QObject * item, int signalIdx, const QQmlOldValue & oldValue) = 0;
+};
+
+template<typename T> class QQmlHasObserver { // detects the classes using QML_OBSERVABLE
+    template<typename U> static char test (decltype (&U::qmlObserver));
+    template<typename U> static long test (...);
+
+public:
+    static const bool value = (sizeof (test<T> (Q_NULLPTR)) == sizeof (char));
+};
+
+template<typename T> inline typename std::enable_if<QQmlHasObserver<T>::value, QQmlItemObserver *>::type qQmlObserverOf (const T * obj) {
+    return obj->qmlObserver ();
+}
+
+template<typename T> inline typename std::enable_if<!QQmlHasObserver<T>::value, QQmlItemObserver *>::type qQmlObserverOf (const T *) {
+    return Q_NULLPTR;
+}
+
+template<typename T> inline typename std::enable_if<QQmlHasObserver<T>::value, bool>::type qQmlAttachObserver (T * obj, QQmlItemObserver * observer) {
+    const bool ret = (obj->qmlObserver () == Q_NULLPTR || obj->qmlObserver () == observer); // NOTE : one observer only
+    if (ret) {
+        obj->setQmlObserver (observer);
+    }
+    return ret;
+}
+
+template<typename T> inline typename std::enable_if<!QQmlHasObserver<T>::value, bool>::type qQmlAttachObserver (T *, QQmlItemObserver *) {
+    return false;
+}
+
+template<typename T> inline typename std::enable_if<QQmlHasObserver<T>::value, bool>::type qQmlDetachObserver (T * obj, QQmlItemObserver * observer) {
+    const bool ret = (obj->qmlObserver () == observer);
+    if (ret) {
+        obj->setQmlObserver (Q_NULLPTR);
+    }
+    return ret;
+}
+
+template<typename T> inline typename std::enable_if<!QQmlHasObserver<T>::value, bool>::type qQmlDetachObserver (T *, QQmlItemObserver *) {
+    return false;
+}
+
+#define QML_NOTIFY_OBSERVER(name, oldValue) \
+    if (QQmlItemObserver * observer = qQmlObserverOf (this)) { \
+        static const int signalIdx = QMetaMethod::fromSignal (&std::remove_pointer<decltype (this)>::type::name##Changed).methodIndex (); \
+        observer->itemPropertyChanged (this, signalIdx, QQmlOldValue (oldValue)); \
+    }
+
+struct QQmlFieldDescriptor { // compile-time accessors of a property, see QML_WRITABLE_PROPERTY
+    int signalIdx; // NOTE : identifies the property without its name
+    QVariant (* read) (const QObject * obj);
+    bool (* write) (QObject * obj, const QVariant & value); // null when read-only
+    void (* copy) (const QObject * from, QObject * to); // typed, no QVariant, null when read-only
+};
+
+namespace QQmlFields { // NOTE : found by ADL only, so that the numbering in a class never changes the meaning of a name
+template<int N = 128> struct Rank : Rank<N - 1> { }; // NOTE : the default is the highest rank, so the most fields per class
+template<> struct Rank<0> { };
+template<int N> struct Count { enum { value = N }; };
+template<int N> struct Slot { };
+
+Count<0> qmlFieldCounter (Rank<0>); // NOTE : declared only, the start of the numbering in every class
+}
+
+template<typename T> inline bool qQmlFieldValue (const QVariant & value, T & out) { // same conversion as QMetaProperty::write
+    bool ret = true;
+    if (!value.isValid ()) {
+        out = T (); // NOTE : a null value resets to the default
+    }
+    else if (value.userType () == qMetaTypeId<T> ()) {
+        out = value.value<T> ();
+    }
+    else {
+        QVariant converted (value);
+        if ((ret = converted.convert (qMetaTypeId<T> ()))) {
+            out = converted.value<T> ();
+        }
+    }
+    return ret;
+}
+
+template<> inline bool qQmlFieldValue<QVariant> (const QVariant & value, QVariant & out) {
+    out = value;
+    return true;
+}
+
+template<typename T, int IDX> struct QQmlFieldAt { // the descriptor in slot IDX, null when T doesn't see it
+    template<typename U> static auto get (int) -> decltype (U::qmlField (QQmlFields::Slot<IDX> (), static_cast<U *> (Q_NULLPTR))) {
+        return U::qmlField (QQmlFields::Slot<IDX> (), static_cast<U *> (Q_NULLPTR));
+    }
+    template<typename U> static const QQmlFieldDescriptor * get (...) {
+        return Q_NULLPTR; // NOTE : numbered by a base class, hidden by the fields of T
+    }
+};
+
+template<typename T, int COUNT> struct QQmlFieldCollector {
+    static void collect (QVector<const QQmlFieldDescriptor *> & list) {
+        QQmlFieldCollector<T, COUNT -1>::collect (list);
+        if (const QQmlFieldDescriptor * field = QQmlFieldAt<T, COUNT -1>::template get<T> (0)) {
+            list.append (field);
+        }
+    }
+};
+
+template<typename T> struct QQmlFieldCollector<T, 0> {
+    static void collect (QVector<const QQmlFieldDescriptor *> &) { }
+};
+
+template<typename T> class QQmlFieldsOf { // lists the descriptors made by the property macros of a class
+    template<typename U> static decltype (U::qmlFieldCounter (QQmlFields::Rank<> ())) count (int);
+    template<typename U> static QQmlFields::Count<0> count (...);
+
+public:
+    static QVector<const QQmlFieldDescriptor *> fields (void) {
+        QVector<const QQmlFieldDescriptor *> ret;
+        QQmlFieldCollector<T, decltype (count<T> (0))::value>::collect (ret);
+        return ret;
+    }
+};
+
+#define QML_FIELD_SLOT(name) \
+    public: \
+        enum { qmlFieldId_##name = decltype (qmlFieldCounter (QQmlFields::Rank<> ()))::value }; \
+        static QQmlFields::Count<qmlFieldId_##name +1> qmlFieldCounter (QQmlFields::Rank<qmlFieldId_##name +1>); \
+        template<typename QmlSelf> static const QQmlFieldDescriptor * qmlField (QQmlFields::Slot<qmlFieldId_##name>, QmlSelf *)
+
+#define QML_FIELD_READ(name) \
+    [] (const QObject * obj) -> QVariant { \
+        return QVariant::fromValue (static_cast<const QmlSelf *> (obj)->get_##name ()); \
+    }
+
+#define QML_WRITABLE_FIELD(name) \
+    QML_FIELD_SLOT (name) { \
+        static const QQmlFieldDescriptor field = { \
+            QMetaMethod::fromSignal (&QmlSelf::name##Changed).methodIndex (), \
+            QML_FIELD_READ (name), \
+            [] (QObject * obj, const QVariant & value) -> bool { \
+                typedef typename std::decay<decltype (std::declval<const QmlSelf &> ().get_##name ())>::type FieldType; \
+                FieldType tmp = FieldType (); \
+                const bool ret = qQmlFieldValue (value, tmp); \
+                if (ret) { \
+                    static_cast<QmlSelf *> (obj)->set_##name (std::move (tmp)); \
+                } \
+                return ret; \
+            }, \
+            [] (const QObject * from, QObject * to) { \
+                static_cast<QmlSelf *> (to)->set_##name (static_cast<const QmlSelf *> (from)->get_##name ()); \
+            } \
+        }; \
+        return &field; \
+    }
+
+#define QML_READONLY_FIELD(name) \
+    QML_FIELD_SLOT (name) { \
+        static const QQmlFieldDescriptor field = { \
+            QMetaMethod::fromSignal (&QmlSelf::name##Changed).methodIndex (), \
+            QML_FIELD_READ (name), \
+            Q_NULLPTR, \
+            Q_NULLPTR \
+        }; \
+        return &field; \
+    }
 
 #define QML_WRITABLE_PROPERTY(type, name) \
     protected: \
@@ -110,13 +349,15 @@
         bool set_##name (type name) { \
             bool ret = false; \
             if ((ret = m_##name != name)) { \
-                m_##name = name; \
+                std::swap (m_##name, name); /* NOTE : the argument now holds the old value, for the observer */ \
                 emit name##Changed (m_##name); \
+                QML_NOTIFY_OBSERVER (name, name) \
             } \
             return ret; \
         } \
     Q_SIGNALS: \
         void name##Changed (type name); \
+    QML_WRITABLE_FIELD (name) \
     private:
 
 #define QML_READONLY_PROPERTY(type, name) \
@@ -131,13 +372,15 @@
         bool update_##name (type name) { \
             bool ret = false; \
             if ((ret = m_##name != name)) { \
-                m_##name = name; \
+                std::swap (m_##name, name); /* NOTE : the argument now holds the old value, for the observer */ \
                 emit name##Changed (m_##name); \
+                QML_NOTIFY_OBSERVER (name, name) \
             } \
             return ret; \
         } \
     Q_SIGNALS: \
         void name##Changed (type name); \
+    QML_READONLY_FIELD (name) \
     private:
 
 #define QML_CONSTANT_PROPERTY(type, name) \
@@ -179,6 +422,17 @@
     private: \
         QList<TYPE *> m_##NAME;
 
+#define QML_OBSERVABLE \
+    public: \
+        QQmlItemObserver * qmlObserver (void) const { \
+            return m_qmlObserver; \
+        } \
+        void setQmlObserver (QQmlItemObserver * observer) { \
+            m_qmlObserver = observer; \
+        } \
+    private: \
+        QQmlItemObserver * m_qmlObserver = Q_NULLPTR;
+
 #define QML_ENUM_CLASS(name, ...) \
     class name : public QObject { \
         Q_GADGET \
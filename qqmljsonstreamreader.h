@@ -0,0 +1,392 @@
+#ifndef QQMLJSONSTREAMREADER_H
+#define QQMLJSONSTREAMREADER_H
+
+/*!
+    \class QQmlJsonStreamReader
+
+    \ingroup QT_QML_MODELS
+
+    \brief A pull tokenizer for JSON documents read incrementally from a device
+
+    Unlike \c QJsonDocument, the document is never loaded nor represented as a whole :
+    the device is read by fixed-size chunks, and each call to readNext() returns the next
+    token (begin / end of object or array, member name, scalar value). The memory used is
+    then bounded by the chunk size and the biggest single string of the document.
+
+    Example in use :
+    \code
+        QQmlJsonStreamReader reader (&file);
+        while (reader.readNext () == QQmlJsonStreamReader::Name) {
+            if (reader.name () == "pages") {
+                reader.readNext ();
+                ...
+            }
+            else {
+                reader.readNext ();
+                reader.skipCurrent ();
+            }
+        }
+    \endcode
+
+    \b Note : The structure is validated as it is read : misplaced or missing commas and colons,
+    unbalanced brackets and trailing content are reported as errors.
+*/
+
+/*!
+    \fn QQmlJsonStreamReader::TokenType QQmlJsonStreamReader::readNext ()
+
+    \details Reads the next token of the document.
+
+    \return The type of the token, \c EndDocument once the device is exhausted, or \c Error
+*/
+
+/*!
+    \fn void QQmlJsonStreamReader::skipCurrent ()
+
+    \details Skips the whole value starting at the current token : when it is the beginning
+    of an object or an array, reads until the matching end, otherwise does nothing.
+*/
+
+
+#include <QByteArray>
+#include <QChar>
+#include <QIODevice>
+#include <QStack>
+#include <QString>
+#include <QStringBuilder>
+#include <QVariant>
+
+#include <cctype>
+
+class QQmlJsonStreamReader {
+public:
+    enum TokenType {
+        Invalid = 0,
+        BeginObject,
+        EndObject,
+        BeginArray,
+        EndArray,
+        Name,
+        Value,
+        EndDocument,
+        Error,
+    };
+
+    explicit QQmlJsonStreamReader (QIODevice * device, int chunkSize = 65536)
+        : m_device (device)
+        , m_chunkSize (chunkSize)
+        , m_pos (0)
+        , m_type (Invalid)
+        , m_separatorExpected (false)
+        , m_afterComma (false)
+    { }
+    TokenType tokenType (void) const {
+        return m_type;
+    }
+    const QString & name (void) const {
+        return m_name;
+    }
+    const QVariant & value (void) const {
+        return m_value;
+    }
+    const QString & errorString (void) const {
+        return m_error;
+    }
+    TokenType readNext (void) {
+        if (m_type == Error) {
+            return m_type;
+        }
+        const bool afterName = (m_type == Name);
+        const bool keyExpected = (!afterName && !m_scopes.isEmpty () && m_scopes.top () == '{');
+        m_value.clear ();
+        char chr = 0;
+        skipSpaces ();
+        if (m_separatorExpected && !m_scopes.isEmpty () && peek (chr) && chr == ',') {
+            m_pos++;
+            m_separatorExpected = false;
+            m_afterComma        = true;
+            skipSpaces ();
+        }
+        if (!peek (chr)) {
+            if (m_scopes.isEmpty () && !afterName) {
+                m_type = EndDocument;
+            }
+            else {
+                fail (QStringLiteral ("Unexpected end of document"));
+            }
+        }
+        else if (chr == '}' || chr == ']') {
+            if (m_scopes.isEmpty () || m_scopes.top () != (chr == '}' ? '{' : '[') || afterName || m_afterComma) {
+                fail (QStringLiteral ("Unexpected ") % QChar::fromLatin1 (chr));
+            }
+            else {
+                m_pos++;
+                m_scopes.pop ();
+                m_type = (chr == '}' ? EndObject : EndArray);
+                valueDone ();
+            }
+        }
+        else if (m_separatorExpected) { // NOTE : a value must be followed by a comma or the end of its scope
+            fail (m_scopes.isEmpty ()
+                  ? QStringLiteral ("Unexpected content after the document")
+                  : QString (QStringLiteral ("Expected a comma before ") % QChar::fromLatin1 (chr)));
+        }
+        else if (chr == '{' || chr == '[') {
+            if (keyExpected) {
+                fail (QStringLiteral ("Expected a member name"));
+            }
+            else {
+                m_pos++;
+                m_scopes.push (chr);
+                m_afterComma = false;
+                m_type = (chr == '{' ? BeginObject : BeginArray);
+            }
+        }
+        else if (chr == '"') {
+            m_pos++;
+            QString str;
+            if (readString (str)) {
+                skipSpaces ();
+                const bool colon = (peek (chr) && chr == ':');
+                if (keyExpected && colon) { // NOTE : a string followed by a colon is a member name
+                    m_pos++;
+                    m_name = str;
+                    m_type = Name;
+                    m_afterComma = false;
+                }
+                else if (keyExpected) {
+                    fail (QStringLiteral ("Expected a colon after a member name"));
+                }
+                else if (colon) {
+                    fail (QStringLiteral ("Unexpected colon"));
+                }
+                else {
+                    m_value = str;
+                    m_type  = Value;
+                    valueDone ();
+                }
+            }
+        }
+        else if (keyExpected) {
+            fail (QStringLiteral ("Expected a member name"));
+        }
+        else if (chr == '-' || (chr >= '0' && chr <= '9')) {
+            readNumber ();
+            if (m_type == Value) {
+                valueDone ();
+            }
+        }
+        else if (chr >= 'a' && chr <= 'z') {
+            QByteArray word;
+            while (peek (chr) && chr >= 'a' && chr <= 'z') {
+                word.append (chr);
+                m_pos++;
+            }
+            if (word == "true" || word == "false") {
+                m_value = (word == "true");
+                m_type  = Value;
+                valueDone ();
+            }
+            else if (word == "null") {
+                m_value = QVariant ();
+                m_type  = Value;
+                valueDone ();
+            }
+            else {
+                fail (QStringLiteral ("Unexpected literal ") % QString::fromLatin1 (word));
+            }
+        }
+        else {
+            fail (QStringLiteral ("Unexpected character ") % QChar::fromLatin1 (chr));
+        }
+        return m_type;
+    }
+    void skipCurrent (void) {
+        if (m_type == BeginObject || m_type == BeginArray) {
+            int depth = 1;
+            while (depth > 0) {
+                switch (readNext ()) {
+                    case BeginObject:
+                    case BeginArray: {
+                        depth++;
+                        break;
+                    }
+                    case EndObject:
+                    case EndArray: {
+                        depth--;
+                        break;
+                    }
+                    case EndDocument:
+                    case Error: {
+                        return;
+                    }
+                    default: break;
+                }
+            }
+        }
+    }
+
+protected:
+    static bool isSpace (char chr) {
+        return (chr == ' ' || chr == '\n' || chr == '\r' || chr == '\t');
+    }
+    void skipSpaces (void) {
+        char chr = 0;
+        while (peek (chr) && isSpace (chr)) {
+            m_pos++;
+        }
+    }
+    void valueDone (void) { // a whole value was read, in its scope or as the document
+        m_separatorExpected = true;
+        m_afterComma        = false;
+    }
+    bool peek (char & chr) {
+        if (m_pos >= m_buffer.size ()) { // refill the buffer with the next chunk
+            m_buffer = (m_device != Q_NULLPTR ? m_device->read (m_chunkSize) : QByteArray ());
+            m_pos    = 0;
+        }
+        const bool ret = (m_pos < m_buffer.size ());
+        if (ret) {
+            chr = m_buffer.at (m_pos);
+        }
+        return ret;
+    }
+    bool expect (char expected) {
+        char chr = 0;
+        const bool ret = (peek (chr) && chr == expected);
+        if (ret) {
+            m_pos++;
+        }
+        return ret;
+    }
+    void fail (const QString & error) {
+        m_error = error;
+        m_type  = Error;
+    }
+    static void appendUtf8 (QByteArray & out, uint code) {
+        if (code < 0x80) {
+            out.append (char (code));
+        }
+        else if (code < 0x800) {
+            out.append (char (0xC0 | (code >> 6)));
+            out.append (char (0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000) {
+            out.append (char (0xE0 | (code >> 12)));
+            out.append (char (0x80 | ((code >> 6) & 0x3F)));
+            out.append (char (0x80 | (code & 0x3F)));
+        }
+        else {
+            out.append (char (0xF0 | (code >> 18)));
+            out.append (char (0x80 | ((code >> 12) & 0x3F)));
+            out.append (char (0x80 | ((code >> 6) & 0x3F)));
+            out.append (char (0x80 | (code & 0x3F)));
+        }
+    }
+    bool readHex (uint & code) {
+        code = 0;
+        char chr = 0;
+        for (int idx = 0; idx < 4; idx++) {
+            if (!peek (chr) || !isxdigit (uchar (chr))) {
+                return false;
+            }
+            code = ((code << 4) | uint (chr <= '9' ? chr - '0' : (chr | 0x20) - 'a' + 10));
+            m_pos++;
+        }
+        return true;
+    }
+    bool readString (QString & str) { // NOTE : the opening quote is already consumed
+        QByteArray utf8;
+        char chr = 0;
+        while (peek (chr)) {
+            m_pos++;
+            if (chr == '"') {
+                str = QString::fromUtf8 (utf8);
+                return true;
+            }
+            else if (chr == '\\') {
+                if (!peek (chr)) {
+                    break;
+                }
+                m_pos++;
+                switch (chr) {
+                    case 'b': utf8.append ('\b'); break;
+                    case 'f': utf8.append ('\f'); break;
+                    case 'n': utf8.append ('\n'); break;
+                    case 'r': utf8.append ('\r'); break;
+                    case 't': utf8.append ('\t'); break;
+                    case 'u': {
+                        uint code = 0;
+                        if (!readHex (code)) {
+                            fail (QStringLiteral ("Invalid unicode escape"));
+                            return false;
+                        }
+                        if (code >= 0xD800 && code < 0xDC00) { // high surrogate, expects the low one
+                            uint low = 0;
+                            if (!expect ('\\') || !expect ('u') || !readHex (low) || low < 0xDC00 || low >= 0xE000) {
+                                fail (QStringLiteral ("Invalid surrogate pair"));
+                                return false;
+                            }
+                            code = (0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00));
+                        }
+                        appendUtf8 (utf8, code);
+                        break;
+                    }
+                    default: utf8.append (chr); break; // NOTE : '"', '\\' and '/'
+                }
+            }
+            else {
+                utf8.append (chr);
+            }
+        }
+        fail (QStringLiteral ("Unterminated string"));
+        return false;
+    }
+    void readNumber (void) {
+        QByteArray num;
+        bool integer = true;
+        char chr = 0;
+        while (peek (chr) && ((chr >= '0' && chr <= '9') || chr == '-' || chr == '+' || chr == '.' || chr == 'e' || chr == 'E')) {
+            if (chr == '.' || chr == 'e' || chr == 'E') {
+                integer = false;
+            }
+            num.append (chr);
+            m_pos++;
+        }
+        bool ok = false;
+        if (integer) {
+            const qlonglong val = num.toLongLong (&ok);
+            if (ok) {
+                m_value = val;
+            }
+        }
+        if (!ok) {
+            const double val = num.toDouble (&ok);
+            if (ok) {
+                m_value = val;
+            }
+        }
+        if (ok) {
+            m_type = Value;
+        }
+        else {
+            fail (QStringLiteral ("Invalid number ") % QString::fromLatin1 (num));
+        }
+    }
+
+private:
+    Q_DISABLE_COPY (QQmlJsonStreamReader)
+    QIODevice * m_device;
+    int         m_chunkSize;
+    QByteArray  m_buffer;
+    int         m_pos;
+    TokenType   m_type;
+    QStack<char> m_scopes; // '{' or '[' for each open object or array
+    bool        m_separatorExpected;
+    bool        m_afterComma;
+    QString     m_name;
+    QVariant    m_value;
+    QString     m_error;
+};
+
+#endif // QQMLJSONSTREAMREADER_H
@@ -0,0 +1,120 @@
+#ifndef QQMLMPSCQUEUE_H
+#define QQMLMPSCQUEUE_H
+
+/*!
+    \class QQmlMpscQueue
+
+    \ingroup QT_QML_MODELS
+
+    \brief A lock-free multi-producer / single-consumer FIFO queue
+
+    Any number of threads can push() values concurrently, without taking a lock,
+    while one single thread (typically the one owning a model) pops them.
+
+    The implementation is the intrusive node-based queue from Dmitry Vyukov :
+    a push is one allocation and one atomic exchange, a pop never blocks and
+    returns \c false when the queue is empty or when a concurrent push of the
+    next value is not finished yet (the value will be available on next pop).
+
+    \b Note : The value type must be default-constructible and copyable.
+*/
+
+/*!
+    \fn void QQmlMpscQueue::push (const T & value)
+
+    \details Enqueues a value. Can be called from any thread.
+
+    \param value The value to enqueue
+*/
+
+/*!
+    \fn bool QQmlMpscQueue::pop (T & value)
+
+    \details Dequeues the oldest value. Must only be called from the consumer thread.
+
+    \param value The value that receives the dequeued one
+    \return Whether a value was dequeued
+*/
+
+/*!
+    \fn int QQmlMpscQueue::count () const
+
+    \details Counts the values pushed and not popped yet. Can be called from any thread.
+
+    \return The current depth of the queue
+*/
+
+
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QtGlobal>
+
+template<typename T> class QQmlMpscQueue {
+public:
+    explicit QQmlMpscQueue (void)
+        : m_head (&m_stub)
+        , m_tail (&m_stub)
+        , m_count (0)
+    { }
+    ~QQmlMpscQueue (void) {
+        T value;
+        while (pop (value)) { }
+    }
+    void push (const T & value) {
+        m_count.ref (); // NOTE : before the node is visible, so that a concurrent pop never makes it negative
+        pushNode (new Node (value));
+    }
+    bool pop (T & value) {
+        Node * tail = m_tail;
+        Node * next = tail->next.loadAcquire ();
+        if (tail == &m_stub) { // skip the stub node
+            if (next == Q_NULLPTR) {
+                return false;
+            }
+            m_tail = next;
+            tail   = next;
+            next   = next->next.loadAcquire ();
+        }
+        if (next == Q_NULLPTR) {
+            if (tail != m_head.loadAcquire ()) {
+                return false; // a producer swapped the head but has not linked its node yet
+            }
+            pushNode (&m_stub); // re-insert the stub so that the last node can be released
+            next = tail->next.loadAcquire ();
+            if (next == Q_NULLPTR) {
+                return false;
+            }
+        }
+        m_tail = next;
+        value = tail->value;
+        delete tail;
+        m_count.deref ();
+        return true;
+    }
+    int count (void) const {
+        return m_count.loadAcquire ();
+    }
+    bool isEmpty (void) const {
+        return (count () == 0);
+    }
+
+private:
+    struct Node {
+        explicit Node (const T & val = T ()) : value (val), next (Q_NULLPTR) { }
+        T                     value;
+        QAtomicPointer<Node>  next;
+    };
+    void pushNode (Node * node) {
+        node->next.storeRelease (Q_NULLPTR);
+        Node * prev = m_head.fetchAndStoreOrdered (node);
+        prev->next.storeRelease (node);
+    }
+    Q_DISABLE_COPY (QQmlMpscQueue)
+
+    Node                 m_stub;
+    QAtomicPointer<Node> m_head; // producers side
+    Node *               m_tail; // consumer side
+    QAtomicInt           m_count;
+};
+
+#endif // QQMLMPSCQUEUE_H
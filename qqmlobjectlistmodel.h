@@ -137,6 +137,10 @@
 
     \param item The pointer to the item
     \return The row index of the item, \c -1 if not found
+
+    \b Note : the model keeps a row index for its items, so this is a constant time lookup
+    (rows shifted by an insertion, removal or move are renumbered lazily on the next lookup).
+    An item should therefore be added only once to a given model.
 */
 
 /*!
@@ -207,6 +211,20 @@
 
     \param idx The current position of the item
     \param pos The position where it willl be after the move
+
+    \sa moveRange(int,int,int)
+*/
+
+
+/*!
+    \details Moves a contiguous block of items from the model to another position,
+    with a single \c rowsMoved() signal so that the views keep their delegates.
+
+    \param idx The current position of the first item of the block
+    \param count The number of items in the block
+    \param pos The position where the first item will be after the move
+
+    \sa move(int,int)
 */
 
 
@@ -224,6 +242,317 @@
 */
 
 
+/*!
+    \details Appends items that were built in another thread, with a single insertion.
+
+    This method is thread-safe. It is meant to be called from the worker thread that created
+    the items (without parent) : they are moved, with their children such as nested models,
+    to the thread of the model, and appended by the event loop of that thread. Several calls
+    made before the event loop picks them up are merged in the same insertion, so the thread
+    of the model only pays for the final splice.
+
+    \param itemList The items to hand over to the model
+*/
+
+
+/*!
+    \details Declares a hash index on a role, kept in sync with the items by the model.
+
+    Like the UID index, the key is the string value of the property, and it is updated through
+    the notify signal of the property. An index can be unique (the last item added or changed
+    wins) or not (several items can share a key).
+
+    In a unique index, the items that lost a key are still remembered as its holders : when
+    the winner is removed or changes, the key points again to the previous item still having it.
+
+    \param name The name of the property / role to index
+    \param unique Whether a key identifies a single item
+    \return Whether the index was added
+
+    \sa findItemBy(), findItemsBy(), findBy(), findAllBy()
+*/
+
+
+/*!
+    \details Retreives an item using a secondary index declared with addIndex().
+
+    \param name The name of the indexed property / role
+    \param value The value to look for
+    \return The item, or \c Q_NULLPTR if not found (or if the role has no index)
+
+    It is meant for unique indexes. With a non-unique one, the result is the most recently indexed
+    holder of the value (the last one added, or whose property changed to it) : use \c findItemsBy()
+    / \c findAllBy() to get all the items sharing the value, most recently indexed first.
+
+    \b Note : \c findBy() is the \c QObject variant for QML.
+*/
+
+
+/*!
+    \details Queues the insertion of an item, from any thread.
+
+    The mutations queued by queueInsert(), queueRemove() and queueSetProperty() go through a
+    lock-free queue and are only applied by drainMutations(), in the thread of the model.
+    Removals and property changes can target an item by pointer or by UID. A pointer is
+    tracked with a \c QPointer, so a mutation targeting an item deleted before the drain is
+    skipped instead of reaching another item allocated at the same address.
+
+    \param item The item, created without parent in the calling thread
+    \param idx The position where the item must be added, \c -1 to append it
+
+    \sa drainMutations(int), setDrainInterval(int,int)
+*/
+
+
+/*!
+    \details Applies the queued mutations, in the thread of the model.
+
+    The drained mutations are applied as one batch, so the views get a coalesced set of
+    signals for all of them.
+
+    \param maxCount The maximum number of mutations to apply, \c -1 for all the pending ones
+    \return The number of applied mutations
+
+    \sa pendingMutations(), lastDrainLatency()
+*/
+
+
+/*!
+    \details Drains the queued mutations periodically (e.g. 16 ms for once per frame).
+
+    \param msec The interval between two drains, \c -1 to stop draining automatically
+    \param maxCount The maximum number of mutations applied by each drain, \c -1 for no limit
+*/
+
+
+/*!
+    \details Replaces the content of the model with the given list, with a minimal edit script.
+
+    When a UID role is set, the incoming items are matched by UID with the current ones : a match
+    keeps the current item (and its delegate), copies the writable role values of the incoming one
+    into it, and deletes the incoming one if it has no parent. Without UID role, the items are
+    matched by pointer.
+
+    The whole replacement is done in a batch, so the views only get the removals, insertions,
+    moves and \c dataChanged() needed to go from the old content to the new one.
+
+    \param itemList The new content of the model
+
+    \sa beginBatch()
+*/
+
+
+/*!
+    \details Opens a batch of modifications (batches can be nested).
+
+    Until the matching endBatch(), the model content seen from C++ is updated right away,
+    but the views keep seeing the rows as they were when the batch started, and no row,
+    \c dataChanged() or \c countChanged() signal is emitted.
+
+    \b Note : \c QQmlObjectListModelBatch is a scoped guard calling both.
+
+    \sa endBatch()
+*/
+
+
+/*!
+    \details Closes a batch of modifications.
+
+    When the outermost batch ends, the difference between the rows known by the views and
+    the current content is replayed as one \c rowsRemoved() per run of removed rows, one
+    \c rowsInserted() per run of added rows, one \c dataChanged() per run of modified rows,
+    and a single \c countChanged(). Surviving rows that were reordered are moved with
+    \c rowsMoved(), only for the rows outside of the longest subsequence that kept its order.
+    If there are too many runs and moves, a single \c modelReset() is emitted instead.
+
+    \sa beginBatch()
+*/
+
+
+/*!
+    \fn static void QQmlObjectListModel::setPoolCapacity (int capacity, const Reset & reset)
+
+    \details Enables the recycling of the items owned by the models of this item type.
+
+    The items removed from a model are never deleted one by one : they are collected and
+    released all at once on next event-loop iteration (after the end of the running batch, if any).
+    With a pool, up to \a capacity of them are then disconnected, reset and kept for acquire()
+    instead of being deleted, so that churn-heavy lists stop allocating and freeing objects.
+
+    The pool is shared by all the models of the item type, so that many small models don't
+    each keep their own idle items.
+
+    The reset is done by the given callable, or by default by writing back into all writable roles
+    the values of a default-constructed item, read once per item type (nested models or other state
+    that isn't a writable property must be handled by a custom callable).
+
+    \param capacity The maximum number of pooled items, \c 0 to disable the pool
+    \param reset A callable taking an \c ItemType* and restoring it to a pristine state
+
+    \sa acquire()
+*/
+
+
+/*!
+    \details Returns an item ready to be filled and added to the model, taken from the pool
+    when there is one, or newly allocated otherwise. The item is owned by the model.
+
+    \return A pointer to the item, or \c Q_NULLPTR if the item class has no default constructor
+    and no factory was given with setItemFactory()
+
+    \sa setPoolCapacity()
+*/
+
+
+/*!
+    \fn void QQmlObjectListModel::setItemFactory (const Factory & factory)
+
+    \details Sets how the model creates the items it decodes (snapshots, JSON import, replication).
+
+    By default the items are default-constructed. Item classes without a default constructor
+    are still usable in a model, but loading or importing content then fails until a factory
+    is given. The factory can be called from the worker thread of an import.
+
+    \param factory A callable returning a new \c ItemType*
+*/
+
+
+/*!
+    \fn bool QQmlObjectListModelBase::saveSnapshot (const QString & path)
+
+    \details Saves the content of the model, and of the models nested in its items, to a binary file.
+
+    The snapshot starts with a magic number and a format version, followed by the model block :
+    the names of the saved roles (the writable ones, and the ones holding a nested model), the
+    row count, and the values of each row. Each nested model is stored as a length-prefixed block
+    of the same shape, so that it can be skipped or decoded later.
+
+    \b Note : Rows still waiting in a page source are not saved, except those of a lazily loaded snapshot.
+
+    \param path The path of the file to write, replaced atomically
+    \return Whether the snapshot was fully written
+
+    \sa loadSnapshot()
+*/
+
+
+/*!
+    \fn bool QQmlObjectListModelBase::loadSnapshot (const QString & path, bool lazy)
+
+    \details Replaces the content of the model with the one of a binary snapshot.
+
+    The file is memory-mapped and decoded in place. The items are created and filled before
+    being added to the model, so that no per-property change is forwarded to the views, and
+    the whole content is added at once. Roles that don't exist anymore are skipped.
+
+    When \a lazy is set, the nested models are not decoded right away : their rows are
+    materialized by \c fetchMore(), as the views scroll to them.
+
+    \param path The path of the file to read
+    \param lazy Whether the nested models should be decoded on demand
+    \return Whether the snapshot was valid and loaded
+
+    \sa saveSnapshot()
+*/
+
+
+/*!
+    \fn int QQmlObjectListModelBase::importJson (QQmlJsonStreamReader & reader, int batchSize)
+
+    \details Appends the items described by a JSON array of objects, parsed incrementally.
+
+    Each member of an object is written in the role of the same name (unknown members are skipped),
+    and a member holding an array fills the model nested in that role, recursively. The items are
+    appended by batches of \a batchSize, so the memory used stays bounded by the size of a batch.
+
+    It can be called from a worker thread : the roles are only read from the shared role table, and
+    each batch is then handed over with postAppend(), so the thread of the model keeps rendering.
+
+    \param reader The JSON reader, positioned before or on the beginning of the array
+    \param batchSize The number of items appended at once
+    \return The number of imported items, or \c -1 if the document is invalid (the items of the
+    batches already appended are kept)
+
+    \sa QQmlJsonStreamReader
+*/
+
+
+/*!
+    \details Enables on-demand population of the model with a page source.
+
+    While the source has more items, the views reading the model (e.g. a \c ListView reaching
+    the end of its content) call \c fetchMore(), which appends the next chunk of items produced
+    by the source. The model can then start empty and only materialize what is scrolled to.
+
+    \param source The page source, or a null pointer to stop fetching
+    \param chunkSize The number of items requested from the source by each \c fetchMore()
+*/
+
+
+/*!
+    \fn void QQmlObjectListModel::setJournalEnabled (bool enabled, qint64 maxBytes)
+
+    \details Enables the undo journal of the model.
+
+    While enabled, the model records a compact entry for each structural change (insertion,
+    removal, move, replacement of the content by syncTo() or removeIf()) and for each change of
+    a writable role of its items, with the old and new values. A batch is recorded as one step,
+    any other change is a step of its own. undo() and redo() replay a step backward or forward,
+    as a single batch, and a new change drops the steps that were undone.
+
+    The old values are handed over by the setters of the \c QML_OBSERVABLE items ; for the other
+    item classes, only the changes made through setData() / setRoleValue() are recorded. The rows
+    brought by fetchMore(), importJson() or postAppend() are loaded data, not edits, so they are
+    left out of the journal, and loadSnapshot() clears it since its steps apply to the old content.
+
+    The removed items owned by the model are kept alive as long as a step can bring them back,
+    and count in \a maxBytes with their nested models ; items not owned by the model must outlive
+    the journal.
+
+    \param enabled Whether the changes should be recorded, disabling it also clears the journal
+    \param maxBytes The estimated memory allowed to the journal, the oldest steps are dropped beyond it
+
+    \sa undo(), redo(), clearJournal()
+*/
+
+
+/*!
+    \details Enables or disables the coalescing of item property changes.
+
+    When enabled, the changes notified by the items are not forwarded right away as one
+    \c dataChanged() per property and per row : the dirty rows and roles are collected and
+    flushed once per event-loop iteration, as one \c dataChanged() per contiguous range of rows
+    carrying the union of the changed roles.
+
+    Disabling it flushes the pending changes immediately.
+
+    \param enabled Whether the changes should be coalesced
+*/
+
+
+/*!
+    \details Remove a contiguous range of items from the model, with a single \c rowsRemoved() signal.
+
+    \param idx The position of the first item to remove
+    \param count The number of items to remove
+*/
+
+
+/*!
+    \fn int QQmlObjectListModel::removeIf (Predicate predicate)
+
+    \details Remove all the items matching a predicate, compacting the list in one pass.
+
+    The removal is done in a batch, so the views get one \c rowsRemoved() per run of
+    removed rows (or a single reset when there are too many runs), and one \c countChanged().
+
+    \param predicate A callable taking an \c ItemType* and returning \c true to remove it
+    \return The number of removed items
+
+    \sa beginBatch()
+*/
+
+
 /*!
     \details Retreives a model item as standard Qt object pointer.
 
@@ -281,18 +610,41 @@
 #include <QAbstractListModel>
 #include <QByteArray>
 #include <QChar>
+#include <QDataStream>
+#include <QDeadlineTimer>
 #include <QDebug>
+#include <QFile>
 #include <QHash>
 #include <QList>
 #include <QMetaMethod>
 #include <QMetaObject>
 #include <QMetaProperty>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QSet>
+#include <QSharedPointer>
 #include <QString>
 #include <QStringBuilder>
+#include <QThread>
+#include <QTimer>
 #include <QVariant>
 #include <QVector>
 
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <type_traits>
+
+#include "qqmlhelpers.h"
+#include "qqmljsonstreamreader.h"
+#include "qqmlmpscqueue.h"
+#include "qqmlobjectlistmodelstats.h"
+
 template<typename T> QList<T> qListFromVariant (const QVariantList & list) {
     QList<T> ret;
     ret.reserve (list.size ());
@@ -321,9 +673,26 @@ template<typename T> QVariantList qListToVariant (const QList<T> & list) {
 class QQmlObjectListModelBase : public QAbstractListModel { // abstract Qt base class
     Q_OBJECT
     Q_PROPERTY (int count READ count NOTIFY countChanged)
+    Q_PROPERTY (bool canUndo READ canUndo NOTIFY journalChanged)
+    Q_PROPERTY (bool canRedo READ canRedo NOTIFY journalChanged)
+#ifdef QQMLOBJECTLISTMODEL_STATS
+    Q_PROPERTY (QQmlObjectListModelStats * stats READ stats CONSTANT)
+#endif
 
 public:
-    explicit QQmlObjectListModelBase (QObject * parent = Q_NULLPTR) : QAbstractListModel (parent) { }
+    explicit QQmlObjectListModelBase (QObject * parent = Q_NULLPTR) : QAbstractListModel (parent) {
+#ifdef QQMLOBJECTLISTMODEL_STATS
+        m_stats = new QQmlObjectListModelStats (this);
+        connect (this, &QQmlObjectListModelBase::countChanged, m_stats, [this] (void) {
+            m_stats->countSignal (QStringLiteral ("countChanged"));
+        });
+#endif
+    }
+#ifdef QQMLOBJECTLISTMODEL_STATS
+    QQmlObjectListModelStats * stats (void) const {
+        return m_stats;
+    }
+#endif
 
 public slots: // virtual methods API for QML
     virtual int size (void) const = 0;
@@ -337,32 +706,177 @@ public slots: // virtual methods API for QML
     virtual void prepend (QObject * item) = 0;
     virtual void insert (int idx, QObject * item) = 0;
     virtual void move (int idx, int pos) = 0;
+    virtual void moveRange (int idx, int count, int pos) = 0;
     virtual void remove (QObject * item) = 0;
     virtual void remove (int idx) = 0;
+    virtual void removeRange (int idx, int count) = 0;
+    virtual int drainMutations (int maxCount = -1) = 0;
+    virtual void beginBatch (void) = 0;
+    virtual void endBatch (void) = 0;
+    virtual bool canUndo (void) const = 0;
+    virtual bool canRedo (void) const = 0;
+    virtual void undo (void) = 0;
+    virtual void redo (void) = 0;
     virtual QObject * get (int idx) const = 0;
     virtual QObject * get (const QString & uid) const = 0;
     virtual QObject * getFirst (void) const = 0;
     virtual QObject * getLast (void) const = 0;
+    virtual QObject * findBy (const QString & name, const QVariant & value) const = 0;
+    virtual QVariantList findAllBy (const QString & name, const QVariant & value) const = 0;
     virtual QVariantList toVarArray (void) const = 0;
+#ifdef QQMLOBJECTLISTMODEL_STATS
+    void dumpStats (void) const {
+        qDebug ().noquote () << m_stats->dump ();
+    }
+#endif
+
+    bool saveSnapshot (const QString & path) {
+        bool ret = false;
+        QSaveFile file (path);
+        if (file.open (QIODevice::WriteOnly)) {
+            QDataStream stream (&file);
+            stream.setVersion (snapshotStreamVersion ());
+            stream << quint32 (SnapshotMagic) << quint16 (SnapshotVersion);
+            writeSnapshot (stream);
+            ret = (stream.status () == QDataStream::Ok && file.commit ());
+        }
+        return ret;
+    }
+    bool loadSnapshot (const QString & path, bool lazy = false) {
+        bool ret = false;
+        QFile file (path);
+        if (file.open (QIODevice::ReadOnly) && file.size () > SnapshotHeaderSize && file.size () < INT_MAX) {
+            const int size = int (file.size ());
+            uchar * map = file.map (0, size);
+            if (map != Q_NULLPTR) {
+                QDataStream header (QByteArray::fromRawData (reinterpret_cast<const char *> (map), SnapshotHeaderSize));
+                header.setVersion (snapshotStreamVersion ());
+                quint32 magic = 0;
+                quint16 version = 0;
+                header >> magic >> version;
+                if (magic == quint32 (SnapshotMagic) && version == quint16 (SnapshotVersion)) {
+                    ret = readSnapshot (QByteArray::fromRawData (reinterpret_cast<const char *> (map + SnapshotHeaderSize), size - SnapshotHeaderSize), lazy);
+                }
+                file.unmap (map); // NOTE : everything kept for later is deep-copied by then
+            }
+        }
+        return ret;
+    }
+
+    int importJsonFile (const QString & path, int batchSize = 500) {
+        int ret = -1;
+        QFile file (path);
+        if (file.open (QIODevice::ReadOnly)) {
+            QQmlJsonStreamReader reader (&file);
+            ret = importJson (reader, batchSize);
+            if (ret < 0) {
+                qWarning () << "Invalid JSON in" << path << ":" << reader.errorString ();
+            }
+        }
+        return ret;
+    }
+
+public: // JSON import, also used recursively for nested models
+    virtual int importJson (QQmlJsonStreamReader & reader, int batchSize = 500) = 0;
+
+public: // snapshot blocks, also used recursively for nested models
+    virtual void writeSnapshot (QDataStream & stream) = 0;
+    virtual bool readSnapshot (const QByteArray & data, bool lazy = false) = 0;
+    virtual void deferSnapshot (const QByteArray & data) = 0;
+
+public: // memory estimate, also used recursively for nested models
+    virtual qint64 estimatedBytes (void) const = 0;
+
+public: // content merge, also used recursively for nested models by syncTo ()
+    virtual void syncFrom (QQmlObjectListModelBase * other) = 0;
+
+public: // delta replication, see QQmlObjectListModelPublisher
+    virtual QByteArray snapshotRows (int first, int count) = 0;
+    virtual bool readRows (const QByteArray & data, int row) = 0;
+    virtual bool setRoleValue (int row, int role, const QVariant & value) = 0;
+    virtual int viewIndexOf (QObject * item) const = 0;
 
 protected slots: // internal callback
     virtual void onItemPropertyChanged (void) = 0;
+    virtual void flushPendingChanges (void) = 0;
+    virtual void onHandoverReady (void) = 0;
+    virtual void releaseItems (void) = 0;
 
 signals: // notifier
     void countChanged (void);
+    void journalChanged (void);
+
+protected: // snapshot format
+    enum {
+        SnapshotMagic      = 0x514F4C4D, // "QOLM"
+        SnapshotVersion    = 1,
+        SnapshotHeaderSize = 6,
+    };
+    static QDataStream::Version snapshotStreamVersion (void) {
+        return QDataStream::Qt_5_6;
+    }
+
+#ifdef QQMLOBJECTLISTMODEL_STATS
+private:
+    QQmlObjectListModelStats * m_stats;
+#endif
 };
 
-template<class ItemType> class QQmlObjectListModel : public QQmlObjectListModelBase {
+class QQmlObjectListModelBatch { // scoped guard for beginBatch () / endBatch ()
 public:
-    explicit QQmlObjectListModel (QObject *          parent      = Q_NULLPTR,
-                                  const QByteArray & displayRole = QByteArray (),
-                                  const QByteArray & uidRole     = QByteArray ())
-        : QQmlObjectListModelBase (parent)
-        , m_count (0)
-        , m_uidRoleName (uidRole)
-        , m_dispRoleName (displayRole)
-        , m_metaObj (ItemType::staticMetaObject)
-    {
+    explicit QQmlObjectListModelBatch (QQmlObjectListModelBase * model) : m_model (model) {
+        if (m_model != Q_NULLPTR) {
+            m_model->beginBatch ();
+        }
+    }
+    ~QQmlObjectListModelBatch (void) {
+        if (m_model != Q_NULLPTR) {
+            m_model->endBatch ();
+        }
+    }
+
+private:
+    Q_DISABLE_COPY (QQmlObjectListModelBatch)
+    QQmlObjectListModelBase * m_model;
+};
+
+template<class ItemType> class QQmlObjectListModelSource { // pluggable page source, see setPageSource ()
+public:
+    virtual ~QQmlObjectListModelSource (void) { }
+    virtual bool hasMore (void) const = 0;
+    virtual QList<ItemType *> fetch (int count) = 0;
+};
+
+template<class ItemType> struct QQmlObjectRoleTable { // role metadata of an item class, built once and shared read-only by its models
+    int                    uidRole;
+    int                    dispRole;
+    QMetaMethod            handler;
+    QMetaProperty          uidProp;
+    QMetaProperty          dispProp;
+    QHash<int, QByteArray> roles;
+    QHash<int, int>        signalIdxToRole;
+    QVector<QMetaProperty> propByRole;
+    QVector<const QQmlFieldDescriptor *> fieldByRole;
+
+    static const QQmlObjectRoleTable * get (const QByteArray & dispRoleName, const QByteArray & uidRoleName) {
+        // NOTE : the table only depends on the item class and the display / UID role names,
+        // so it is built once and shared read-only by all the models using that configuration
+        static QMutex mutex;
+        static QHash<QByteArray, QSharedPointer<QQmlObjectRoleTable> > tables;
+        QMutexLocker locker (&mutex);
+        const QByteArray key = (dispRoleName % '/' % uidRoleName);
+        QSharedPointer<QQmlObjectRoleTable> & ret = tables [key];
+        if (ret.isNull ()) {
+            ret = QSharedPointer<QQmlObjectRoleTable> (new QQmlObjectRoleTable);
+            ret->build (dispRoleName, uidRoleName);
+        }
+        return ret.data ();
+    }
+    static int baseRole (void) {
+        return Qt::UserRole;
+    }
+
+    void build (const QByteArray & dispRoleName, const QByteArray & uidRoleName) {
         static QSet<QByteArray> roleNamesBlacklist;
         if (roleNamesBlacklist.isEmpty ()) {
             roleNamesBlacklist << QByteArrayLiteral ("id")
@@ -372,47 +886,112 @@ public:
                                << QByteArrayLiteral ("modelData");
         }
         static const char * HANDLER = "onItemPropertyChanged()";
-        m_handler = metaObject ()->method (metaObject ()->indexOfMethod (HANDLER));
-        if (!displayRole.isEmpty ()) {
-            m_roles.insert (Qt::DisplayRole, QByteArrayLiteral ("display"));
+        const QMetaObject & baseMetaObj = QQmlObjectListModelBase::staticMetaObject;
+        handler = baseMetaObj.method (baseMetaObj.indexOfMethod (HANDLER));
+        if (!dispRoleName.isEmpty ()) {
+            roles.insert (Qt::DisplayRole, QByteArrayLiteral ("display"));
         }
-        m_roles.insert (baseRole (), QByteArrayLiteral ("qtObject"));
-        const int len = m_metaObj.propertyCount ();
+        roles.insert (baseRole (), QByteArrayLiteral ("qtObject"));
+        const QMetaObject & metaObj = ItemType::staticMetaObject;
+        const int len = metaObj.propertyCount ();
+        propByRole.resize (len +1);
         for (int propertyIdx = 0, role = (baseRole () +1); propertyIdx < len; propertyIdx++, role++) {
-            QMetaProperty metaProp = m_metaObj.property (propertyIdx);
+            QMetaProperty metaProp = metaObj.property (propertyIdx);
             const QByteArray propName = QByteArray (metaProp.name ());
             if (!roleNamesBlacklist.contains (propName)) {
-                m_roles.insert (role, propName);
+                roles.insert (role, propName);
+                propByRole [role - baseRole ()] = metaProp;
                 if (metaProp.hasNotifySignal ()) {
-                    m_signalIdxToRole.insert (metaProp.notifySignalIndex (), role);
+                    signalIdxToRole.insert (metaProp.notifySignalIndex (), role);
                 }
             }
             else {
-                static const QByteArray CLASS_NAME = (QByteArrayLiteral ("QQmlObjectListModel<") % m_metaObj.className () % '>');
-                qWarning () << "Can't have" << propName << "as a role name in" << qPrintable (CLASS_NAME);
+                qWarning () << "Can't have" << propName << "as a role name in" << metaObj.className (); // NOTE : shared by the object and gadget models
+            }
+        }
+        fieldByRole.fill (Q_NULLPTR, len +1);
+        const QVector<const QQmlFieldDescriptor *> fields = QQmlFieldsOf<ItemType>::fields ();
+        for (int idx = 0; idx < fields.count (); idx++) {
+            const QQmlFieldDescriptor * field = fields.at (idx);
+            const int role = signalIdxToRole.value (field->signalIdx, -1); // NOTE : matched by notifier, no name lookup
+            if (role > baseRole ()) {
+                fieldByRole [role - baseRole ()] = field;
             }
         }
+        uidRole  = (!uidRoleName.isEmpty ()  ? roles.key (uidRoleName, -1)  : -1);
+        dispRole = (!dispRoleName.isEmpty () ? roles.key (dispRoleName, -1) : -1);
+        uidProp  = (uidRole  > baseRole () ? propByRole.at (uidRole  - baseRole ()) : QMetaProperty ());
+        dispProp = (dispRole > baseRole () ? propByRole.at (dispRole - baseRole ()) : QMetaProperty ());
     }
-    bool setData (const QModelIndex & index, const QVariant & value, int role) Q_DECL_FINAL {
-        bool ret = false;
-        ItemType * item = at (index.row ());
-        const QByteArray rolename = (role != Qt::DisplayRole ? m_roles.value (role, emptyBA ()) : m_dispRoleName);
-        if (item != Q_NULLPTR && role != baseRole () && !rolename.isEmpty ()) {
-            ret = item->setProperty (rolename, value);
+};
+
+template<class ItemType> class QQmlObjectListModel : public QQmlObjectListModelBase, protected QQmlItemObserver {
+    typedef QQmlObjectRoleTable<ItemType> RoleTable; // shared per-type role metadata
+    struct SecondaryIndex; // see addIndex ()
+    struct SnapshotLayout; // see writeSnapshot ()
+    class SnapshotSource; // see deferSnapshot ()
+    struct ItemPool; // see setPoolCapacity ()
+    struct JournalEntry; // see setJournalEnabled ()
+    typedef QVector<JournalEntry> JournalGroup; // one undo step
+
+public:
+    typedef std::function<void (ItemType *)> Reset;
+    typedef std::function<ItemType * (void)> Factory;
+
+    explicit QQmlObjectListModel (QObject *          parent      = Q_NULLPTR,
+                                  const QByteArray & displayRole = QByteArray (),
+                                  const QByteArray & uidRole     = QByteArray ())
+        : QQmlObjectListModelBase (parent)
+        , m_count (0)
+        , m_batchDepth (0)
+        , m_coalescing (false)
+        , m_flushQueued (false)
+        , m_meta (roleTable (displayRole, uidRole))
+        , m_rowsDirtyFrom (INT_MAX)
+        , m_drainTimer (Q_NULLPTR)
+        , m_drainBudget (-1)
+        , m_drainLatency (0)
+        , m_fetchChunk (0)
+        , m_releaseQueued (false)
+        , m_journaling (false)
+        , m_journalReplaying (false)
+        , m_journalPaused (0)
+        , m_journalMaxBytes (0)
+        , m_journalBytes (0)
+    { }
+    ~QQmlObjectListModel (void) {
+        FOREACH_PTR_IN_QLIST (ItemType, item, m_items) {
+            qQmlDetachObserver (item, this); // NOTE : the items not owned by the model outlive it
         }
-        return ret;
+        qDeleteAll (m_handover); // handed over by another thread but never appended
+        QSet<ItemType *> queued; // the same goes for the items of the insertions never drained
+        Mutation mutation;
+        while (m_mutations.pop (mutation)) {
+            if (mutation.type == Mutation::Insert && mutation.item != Q_NULLPTR && !m_rowByItem.contains (mutation.item)) {
+                queued.insert (mutation.item);
+            }
+        }
+        qDeleteAll (queued);
+    }
+    bool setData (const QModelIndex & index, const QVariant & value, int role) Q_DECL_FINAL {
+        QQML_OBJMODEL_STAT (stats ()->countSetData ();)
+        return setRoleValue (viewAt (index.row ()), role, value);
     }
     QVariant data (const QModelIndex & index, int role) const Q_DECL_FINAL {
-        QVariant ret;
-        ItemType * item = at (index.row ());
-        const QByteArray rolename = (role != Qt::DisplayRole ? m_roles.value (role, emptyBA ()) : m_dispRoleName);
-        if (item != Q_NULLPTR && !rolename.isEmpty ()) {
-            ret.setValue (role != baseRole () ? item->property (rolename) : QVariant::fromValue (static_cast<QObject *> (item)));
-        }
-        return ret;
+        QQML_OBJMODEL_STAT (stats ()->countData (role);)
+        return roleValue (viewAt (index.row ()), role);
     }
     QHash<int, QByteArray> roleNames (void) const Q_DECL_FINAL {
-        return m_roles;
+        return m_meta->roles;
+    }
+    bool canFetchMore (const QModelIndex & parent) const Q_DECL_FINAL {
+        return (!parent.isValid () && !m_pageSource.isNull () && m_pageSource->hasMore ());
+    }
+    void fetchMore (const QModelIndex & parent) Q_DECL_FINAL {
+        if (canFetchMore (parent)) {
+            const JournalPause pause (this); // NOTE : undoing a fetched chunk would lose it, the source can't fetch it again
+            append (m_pageSource->fetch (m_fetchChunk));
+        }
     }
     typedef typename QList<ItemType *>::const_iterator const_iterator;
     const_iterator begin (void) const {
@@ -429,6 +1008,38 @@ public:
     }
 
 public: // C++ API
+    QVariant roleValue (ItemType * item, int role) const {
+        QVariant ret;
+        if (item != Q_NULLPTR) {
+            if (role != baseRole ()) {
+                const QMetaProperty & metaProp = propertyForRole (role);
+                if (metaProp.isValid ()) {
+                    ret = readProperty (metaProp, item);
+                }
+            }
+            else {
+                ret = QVariant::fromValue (static_cast<QObject *> (item));
+            }
+        }
+        return ret;
+    }
+    bool setRoleValue (ItemType * item, int role, const QVariant & value) {
+        bool ret = false;
+        if (item != Q_NULLPTR && role != baseRole ()) {
+            const QMetaProperty & metaProp = propertyForRole (role);
+            if (metaProp.isValid ()) {
+                if (!QQmlHasObserver<ItemType>::value && isJournaling () && m_rowByItem.contains (item)) { // NOTE : without QML_OBSERVABLE, only the writes made here know the old value
+                    const QVariant oldValue = readProperty (metaProp, item);
+                    ret = writeProperty (metaProp, item, value);
+                    journalProperty (item, role, oldValue);
+                }
+                else {
+                    ret = writeProperty (metaProp, item, value);
+                }
+            }
+        }
+        return ret;
+    }
     ItemType * at (int idx) const {
         ItemType * ret = Q_NULLPTR;
         if (idx >= 0 && idx < m_items.size ()) {
@@ -440,130 +1051,482 @@ public: // C++ API
         return (!m_indexByUid.isEmpty () ? m_indexByUid.value (uid, Q_NULLPTR) : Q_NULLPTR);
     }
     int roleForName (const QByteArray & name) const Q_DECL_FINAL {
-        return m_roles.key (name, -1);
+        return m_meta->roles.key (name, -1);
     }
     int count (void) const Q_DECL_FINAL {
-        return m_count;
+        return m_items.count ();
     }
     int size (void) const Q_DECL_FINAL {
-        return m_count;
+        return m_items.count ();
     }
     bool isEmpty (void) const Q_DECL_FINAL {
         return m_items.isEmpty ();
     }
     bool contains (ItemType * item) const {
-        return m_items.contains (item);
+        return (item != Q_NULLPTR && m_rowByItem.contains (item));
     }
     int indexOf (ItemType * item) const {
-        return m_items.indexOf (item);
+        int ret = -1;
+        if (item != Q_NULLPTR) {
+            typename QHash<ItemType *, int>::const_iterator it = m_rowByItem.constFind (item);
+            if (it != m_rowByItem.constEnd ()) {
+                if (it.value () >= m_rowsDirtyFrom) {
+                    reindexRows ();
+                    it = m_rowByItem.constFind (item);
+                }
+                ret = it.value ();
+            }
+        }
+        return ret;
     }
     void clear (void) Q_DECL_FINAL {
         if (!m_items.isEmpty ()) {
-            beginRemoveRows (noParent (), 0, m_items.count () -1);
+            beginRemoveItems (0, m_items.count () -1);
             FOREACH_PTR_IN_QLIST (ItemType, item, m_items) {
                 dereferenceItem (item);
             }
             m_items.clear ();
-            updateCounter ();
-            endRemoveRows ();
+            m_rowByItem.clear ();
+            m_rowsDirtyFrom = INT_MAX;
+            endRemoveItems ();
         }
     }
     void append (ItemType * item) {
         if (item != Q_NULLPTR) {
             const int pos = m_items.count ();
-            beginInsertRows (noParent (), pos, pos);
+            beginInsertItems (pos, pos);
             m_items.append (item);
+            indexInsertedRows (pos, 1);
             referenceItem (item);
-            updateCounter ();
-            endInsertRows ();
+            endInsertItems ();
         }
     }
     void prepend (ItemType * item) {
         if (item != Q_NULLPTR) {
-            beginInsertRows (noParent (), 0, 0);
+            beginInsertItems (0, 0);
             m_items.prepend (item);
+            indexInsertedRows (0, 1);
             referenceItem (item);
-            updateCounter ();
-            endInsertRows ();
+            endInsertItems ();
         }
     }
     void insert (int idx, ItemType * item) {
         if (item != Q_NULLPTR) {
-            beginInsertRows (noParent (), idx, idx);
+            beginInsertItems (idx, idx);
             m_items.insert (idx, item);
+            indexInsertedRows (idx, 1);
             referenceItem (item);
-            updateCounter ();
-            endInsertRows ();
+            endInsertItems ();
         }
     }
     void append (const QList<ItemType *> & itemList) {
         if (!itemList.isEmpty ()) {
             const int pos = m_items.count ();
-            beginInsertRows (noParent (), pos, pos + itemList.count () -1);
+            beginInsertItems (pos, pos + itemList.count () -1);
             m_items.reserve (m_items.count () + itemList.count ());
             m_items.append (itemList);
+            indexInsertedRows (pos, itemList.count ());
             FOREACH_PTR_IN_QLIST (ItemType, item, itemList) {
                 referenceItem (item);
             }
-            updateCounter ();
-            endInsertRows ();
+            endInsertItems ();
         }
     }
     void prepend (const QList<ItemType *> & itemList) {
-        if (!itemList.isEmpty ()) {
-            beginInsertRows (noParent (), 0, itemList.count () -1);
-            m_items.reserve (m_items.count () + itemList.count ());
-            int offset = 0;
-            FOREACH_PTR_IN_QLIST (ItemType, item, itemList) {
-                m_items.insert (offset, item);
-                referenceItem (item);
-                offset++;
-            }
-            updateCounter ();
-            endInsertRows ();
-        }
+        insert (0, itemList);
     }
     void insert (int idx, const QList<ItemType *> & itemList) {
         if (!itemList.isEmpty ()) {
-            beginInsertRows (noParent (), idx, idx + itemList.count () -1);
-            m_items.reserve (m_items.count () + itemList.count ());
-            int offset = 0;
+            beginInsertItems (idx, idx + itemList.count () -1);
+            const int pos = m_items.count ();
+            m_items.reserve (pos + itemList.count ());
+            m_items.append (itemList);
+            if (idx < pos) { // NOTE : one shift of the tail instead of one per inserted item
+                std::rotate (m_items.begin () + idx, m_items.begin () + pos, m_items.end ());
+            }
+            indexInsertedRows (idx, itemList.count ());
             FOREACH_PTR_IN_QLIST (ItemType, item, itemList) {
-                m_items.insert (idx + offset, item);
                 referenceItem (item);
-                offset++;
             }
-            updateCounter ();
-            endInsertRows ();
+            endInsertItems ();
         }
     }
     void move (int idx, int pos) Q_DECL_FINAL {
-        if (idx != pos) {
-            // FIXME : use begin/end MoveRows when supported by Repeater, since then use remove/insert pair
-            //beginMoveRows (noParent (), idx, idx, noParent (), (idx < pos ? pos +1 : pos));
-            beginRemoveRows (noParent (), idx, idx);
-            beginInsertRows (noParent (), pos, pos);
-            m_items.move (idx, pos);
-            endRemoveRows ();
-            endInsertRows ();
-            //endMoveRows ();
+        moveRange (idx, 1, pos);
+    }
+    void moveRange (int idx, int count, int pos) Q_DECL_FINAL {
+        if (idx != pos && count > 0 && idx >= 0 && pos >= 0 && idx + count <= m_items.count () && pos + count <= m_items.count ()) {
+            const bool notify = !isBatching ();
+            if (!notify || beginMoveRows (noParent (), idx, idx + count -1, noParent (), (idx < pos ? pos + count : pos))) {
+                typename QList<ItemType *>::iterator first = m_items.begin ();
+                if (idx < pos) {
+                    std::rotate (first + idx, first + idx + count, first + pos + count);
+                }
+                else {
+                    std::rotate (first + pos, first + idx, first + idx + count);
+                }
+                invalidateRows (qMin (idx, pos));
+                if (notify) {
+                    endMoveRows ();
+                }
+                if (isJournaling ()) {
+                    JournalEntry entry (JournalEntry::Move, idx, count);
+                    entry.pos = pos;
+                    journalRecord (entry);
+                }
+            }
         }
     }
     void remove (ItemType * item) {
         if (item != Q_NULLPTR) {
-            const int idx = m_items.indexOf (item);
+            const int idx = indexOf (item);
             remove (idx);
         }
     }
     void remove (int idx) Q_DECL_FINAL {
         if (idx >= 0 && idx < m_items.size ()) {
-            beginRemoveRows (noParent (), idx, idx);
+            beginRemoveItems (idx, idx);
             ItemType * item = m_items.takeAt (idx);
+            invalidateRows (idx);
             dereferenceItem (item);
-            updateCounter ();
-            endRemoveRows ();
+            endRemoveItems ();
         }
     }
+    void removeRange (int idx, int count) Q_DECL_FINAL {
+        if (idx >= 0 && idx < m_items.size () && count > 0) {
+            const int last = (qMin (idx + count, m_items.size ()) -1);
+            beginRemoveItems (idx, last);
+            for (int row = idx; row <= last; row++) {
+                dereferenceItem (m_items.at (row));
+            }
+            m_items.erase (m_items.begin () + idx, m_items.begin () + last +1);
+            invalidateRows (idx);
+            endRemoveItems ();
+        }
+    }
+    template<typename Predicate> int removeIf (Predicate predicate) {
+        int ret = 0;
+        if (!m_items.isEmpty ()) {
+            beginBatch (); // NOTE : the batch replays one rowsRemoved per run of removed rows
+            const QList<ItemType *> before = (isJournaling () ? m_items : QList<ItemType *> ());
+            int kept = 0;
+            for (int row = 0; row < m_items.count (); row++) {
+                ItemType * item = m_items.at (row);
+                if (item != Q_NULLPTR && predicate (item)) {
+                    dereferenceItem (item);
+                    ret++;
+                }
+                else {
+                    if (kept != row) {
+                        m_items [kept] = item;
+                    }
+                    kept++;
+                }
+            }
+            if (ret > 0) {
+                m_items.erase (m_items.begin () + kept, m_items.end ());
+                m_rowsDirtyFrom = 0;
+                journalReplace (before);
+            }
+            endBatch ();
+        }
+        return ret;
+    }
+    void postAppend (const QList<ItemType *> & itemList) { // thread-safe
+        QList<ItemType *> handover;
+        handover.reserve (itemList.count ());
+        FOREACH_PTR_IN_QLIST (ItemType, item, itemList) {
+            if (item->thread () != thread ()) {
+                item->moveToThread (thread ()); // NOTE : also moves the children, like nested models
+            }
+            handover.append (item);
+        }
+        if (!handover.isEmpty ()) {
+            QMutexLocker locker (&m_handoverMutex);
+            const bool wasEmpty = m_handover.isEmpty ();
+            m_handover.append (handover);
+            if (wasEmpty) {
+                QMetaObject::invokeMethod (this, "onHandoverReady", Qt::QueuedConnection);
+            }
+        }
+    }
+    bool addIndex (const QByteArray & name, bool unique = false) {
+        bool ret = false;
+        const int role = roleForName (name);
+        const QMetaProperty & metaProp = propertyForRole (role);
+        if (metaProp.isValid () && role != Qt::DisplayRole && !m_indexes.contains (role)) {
+            SecondaryIndex & index = m_indexes [role];
+            index.prop   = metaProp;
+            index.unique = unique;
+            index.itemsByKey.reserve (m_items.count ());
+            index.keyByItem.reserve (m_items.count ());
+            FOREACH_PTR_IN_QLIST (ItemType, item, m_items) {
+                indexItem (index, item);
+            }
+            ret = true;
+        }
+        return ret;
+    }
+    void removeIndex (const QByteArray & name) {
+        m_indexes.remove (roleForName (name));
+    }
+    ItemType * findItemBy (const QByteArray & name, const QVariant & value) const { // NOTE : latest holder for a non-unique index
+        typename QHash<int, SecondaryIndex>::const_iterator it = m_indexes.constFind (roleForName (name));
+        return (it != m_indexes.constEnd () ? it.value ().itemsByKey.value (value.toString (), Q_NULLPTR) : Q_NULLPTR);
+    }
+    QList<ItemType *> findItemsBy (const QByteArray & name, const QVariant & value) const {
+        typename QHash<int, SecondaryIndex>::const_iterator it = m_indexes.constFind (roleForName (name));
+        QList<ItemType *> ret;
+        if (it != m_indexes.constEnd ()) {
+            if (it.value ().unique) {
+                if (ItemType * item = it.value ().itemsByKey.value (value.toString (), Q_NULLPTR)) {
+                    ret.append (item);
+                }
+            }
+            else {
+                ret = it.value ().itemsByKey.values (value.toString ());
+            }
+        }
+        return ret;
+    }
+    void queueInsert (ItemType * item, int idx = -1) { // thread-safe
+        if (item != Q_NULLPTR) {
+            if (item->thread () != thread ()) {
+                item->moveToThread (thread ());
+            }
+            m_mutations.push (Mutation (Mutation::Insert, item, emptyStr (), idx));
+        }
+    }
+    void queueRemove (ItemType * item) { // thread-safe
+        if (item != Q_NULLPTR) {
+            m_mutations.push (Mutation (Mutation::Remove, item, emptyStr ()));
+        }
+    }
+    void queueRemove (const QString & uid) { // thread-safe
+        m_mutations.push (Mutation (Mutation::Remove, Q_NULLPTR, uid));
+    }
+    void queueSetProperty (ItemType * item, const QByteArray & name, const QVariant & value) { // thread-safe
+        if (item != Q_NULLPTR) {
+            m_mutations.push (Mutation (Mutation::SetProperty, item, emptyStr (), roleForName (name), value));
+        }
+    }
+    void queueSetProperty (const QString & uid, const QByteArray & name, const QVariant & value) { // thread-safe
+        m_mutations.push (Mutation (Mutation::SetProperty, Q_NULLPTR, uid, roleForName (name), value));
+    }
+    int drainMutations (int maxCount = -1) Q_DECL_FINAL {
+        int ret = 0;
+        if (!m_mutations.isEmpty ()) {
+            const qint64 now = QDeadlineTimer::current (Qt::PreciseTimer).deadlineNSecs ();
+            qint64 oldest = now;
+            beginBatch ();
+            Mutation mutation;
+            while ((maxCount < 0 || ret < maxCount) && m_mutations.pop (mutation)) {
+                ItemType * item = (!mutation.uid.isEmpty () ? getByUid (mutation.uid) : (mutation.type == Mutation::Insert ? mutation.item : mutation.target.data ()));
+                switch (mutation.type) {
+                    case Mutation::Insert: {
+                        if (mutation.index >= 0 && mutation.index <= m_items.count ()) {
+                            insert (mutation.index, item);
+                        }
+                        else {
+                            append (item);
+                        }
+                        break;
+                    }
+                    case Mutation::Remove: {
+                        remove (item);
+                        break;
+                    }
+                    case Mutation::SetProperty: {
+                        const QMetaProperty & metaProp = propertyForRole (mutation.index);
+                        if (metaProp.isValid () && contains (item)) {
+                            writeProperty (metaProp, item, mutation.value);
+                        }
+                        break;
+                    }
+                }
+                oldest = qMin (oldest, mutation.stamp);
+                ret++;
+            }
+            endBatch ();
+            m_drainLatency = (now - oldest);
+        }
+        return ret;
+    }
+    void setDrainInterval (int msec, int maxCount = -1) {
+        m_drainBudget = maxCount;
+        if (msec >= 0) {
+            if (m_drainTimer == Q_NULLPTR) {
+                m_drainTimer = new QTimer (this);
+                connect (m_drainTimer, &QTimer::timeout, this, [this] (void) { drainMutations (m_drainBudget); });
+            }
+            m_drainTimer->start (msec);
+        }
+        else if (m_drainTimer != Q_NULLPTR) {
+            m_drainTimer->stop ();
+        }
+    }
+    int pendingMutations (void) const {
+        return m_mutations.count ();
+    }
+    qint64 lastDrainLatency (void) const {
+        return m_drainLatency;
+    }
+    void syncTo (const QList<ItemType *> & itemList) {
+        beginBatch ();
+        const QList<ItemType *> before = (isJournaling () ? m_items : QList<ItemType *> ());
+        QList<ItemType *> target;
+        QSet<ItemType *> kept;
+        target.reserve (itemList.count ());
+        kept.reserve (itemList.count ());
+        FOREACH_PTR_IN_QLIST (ItemType, item, itemList) {
+            ItemType * existing = item;
+            if (m_meta->uidProp.isValid ()) { // reuse the item already known for that UID
+                const QString key = readProperty (m_meta->uidProp, item).toString ();
+                ItemType * known = (!key.isEmpty () ? getByUid (key) : Q_NULLPTR);
+                if (known != Q_NULLPTR && known != item) {
+                    copyRoles (item, known);
+                    existing = known;
+                    if (item->parent () == Q_NULLPTR) {
+                        item->deleteLater ();
+                    }
+                }
+            }
+            if (!kept.contains (existing)) {
+                kept.insert (existing);
+                target.append (existing);
+            }
+        }
+        replaceItems (target, kept);
+        journalReplace (before);
+        endBatch ();
+    }
+    void beginBatch (void) Q_DECL_FINAL {
+        if (m_batchDepth++ == 0) {
+            m_batchView = m_items; // implicitly shared, only detached by the first structural change
+            m_batchViewRows.clear ();
+        }
+    }
+    void endBatch (void) Q_DECL_FINAL {
+        if (m_batchDepth > 0 && --m_batchDepth == 0) {
+            publishBatch ();
+            if (!m_graveyard.isEmpty ()) {
+                scheduleRelease ();
+            }
+            closeJournalGroup (); // NOTE : the whole batch is undone as one step
+        }
+    }
+    static void setPoolCapacity (int capacity, const Reset & reset = Reset ()) { // NOTE : for all the models of the item type
+        ItemPool & pool = itemPool ();
+        QList<ItemType *> dropped;
+        bool needDefaults = false;
+        {
+            QMutexLocker locker (&pool.mutex);
+            pool.capacity = qMax (capacity, 0);
+            pool.reset    = reset;
+            needDefaults  = (pool.capacity > 0 && !pool.reset && !pool.defaultsKnown);
+            while (pool.items.count () > pool.capacity) {
+                dropped.append (pool.items.takeLast ());
+            }
+        }
+        if (needDefaults) { // NOTE : a single prototype per item type
+            const QScopedPointer<ItemType> prototype (defaultItem<ItemType> ());
+            QVector<QPair<QMetaProperty, QVariant> > defaults;
+            const RoleTable * meta = roleTable (QByteArray (), QByteArray ());
+            for (int idx = 0; idx < meta->propByRole.count () && !prototype.isNull (); idx++) {
+                const QMetaProperty & metaProp = meta->propByRole.at (idx);
+                if (metaProp.isValid () && metaProp.isWritable ()) {
+                    defaults.append (qMakePair (metaProp, metaProp.read (prototype.data ())));
+                }
+            }
+            QMutexLocker locker (&pool.mutex);
+            pool.defaults      = defaults;
+            pool.defaultsKnown = true;
+        }
+        qDeleteAll (dropped);
+    }
+    static int poolCapacity (void) {
+        ItemPool & pool = itemPool ();
+        QMutexLocker locker (&pool.mutex);
+        return pool.capacity;
+    }
+    static int pooledCount (void) {
+        ItemPool & pool = itemPool ();
+        QMutexLocker locker (&pool.mutex);
+        return pool.items.count ();
+    }
+    ItemType * acquire (void) {
+        ItemType * ret = Q_NULLPTR;
+        {
+            ItemPool & pool = itemPool ();
+            QMutexLocker locker (&pool.mutex);
+            for (int idx = pool.items.count () -1; idx >= 0 && ret == Q_NULLPTR; idx--) {
+                if (pool.items.at (idx)->thread () == thread ()) { // NOTE : only the items living in the thread of this model
+                    ret = pool.items.takeAt (idx);
+                }
+            }
+        }
+        if (ret == Q_NULLPTR) {
+            ret = createItem ();
+        }
+        if (ret != Q_NULLPTR) {
+            ret->setParent (this);
+        }
+        return ret;
+    }
+    void setItemFactory (const Factory & factory) {
+        m_factory = factory;
+    }
+    ItemType * createItem (void) const { // NOTE : can be called from another thread by importJson ()
+        return (m_factory ? m_factory () : defaultItem<ItemType> ());
+    }
+    void setPageSource (const QSharedPointer<QQmlObjectListModelSource<ItemType> > & source, int chunkSize = 50) {
+        m_pageSource = source;
+        m_fetchChunk = qMax (chunkSize, 1);
+    }
+    QSharedPointer<QQmlObjectListModelSource<ItemType> > pageSource (void) const {
+        return m_pageSource;
+    }
+    void setJournalEnabled (bool enabled, qint64 maxBytes = (4 * 1024 * 1024)) {
+        m_journalMaxBytes = qMax (maxBytes, qint64 (0));
+        if (m_journaling != enabled) {
+            if (!enabled) {
+                clearJournal ();
+            }
+            m_journaling = enabled;
+        }
+        else if (trimJournal ()) {
+            emit journalChanged ();
+        }
+    }
+    bool isJournalEnabled (void) const {
+        return m_journaling;
+    }
+    qint64 journalBytes (void) const {
+        return m_journalBytes;
+    }
+    void clearJournal (void) {
+        const bool hadSteps = (canUndo () || canRedo ());
+        dropJournalEntries (m_journalOpen);
+        dropJournalGroups (m_undo, m_undo.count ());
+        dropJournalGroups (m_redo, m_redo.count ());
+        if (hadSteps) {
+            emit journalChanged ();
+        }
+    }
+    bool isBatching (void) const {
+        return (m_batchDepth > 0);
+    }
+    void setCoalescingEnabled (bool enabled) {
+        if (m_coalescing != enabled) {
+            m_coalescing = enabled;
+            if (!enabled) {
+                flushPendingChanges ();
+            }
+        }
+    }
+    bool isCoalescingEnabled (void) const {
+        return m_coalescing;
+    }
     ItemType * first (void) const {
         return m_items.first ();
     }
@@ -608,9 +1571,213 @@ public: // QML slots implementation
     QObject * getLast (void) const Q_DECL_FINAL {
         return static_cast<QObject *> (last ());
     }
+    QObject * findBy (const QString & name, const QVariant & value) const Q_DECL_FINAL {
+        return static_cast<QObject *> (findItemBy (name.toUtf8 (), value));
+    }
+    QVariantList findAllBy (const QString & name, const QVariant & value) const Q_DECL_FINAL {
+        return qListToVariant<ItemType *> (findItemsBy (name.toUtf8 (), value));
+    }
     QVariantList toVarArray (void) const Q_DECL_FINAL {
         return qListToVariant<ItemType *> (m_items);
     }
+    bool canUndo (void) const Q_DECL_FINAL {
+        return (!m_undo.isEmpty () || !m_journalOpen.isEmpty ());
+    }
+    bool canRedo (void) const Q_DECL_FINAL {
+        return !m_redo.isEmpty ();
+    }
+    void undo (void) Q_DECL_FINAL {
+        closeJournalGroup ();
+        if (!m_undo.isEmpty ()) {
+            JournalGroup group = m_undo.takeLast ();
+            replayJournalGroup (group, true);
+            m_redo.append (group);
+            emit journalChanged ();
+        }
+    }
+    void redo (void) Q_DECL_FINAL {
+        closeJournalGroup ();
+        if (!m_redo.isEmpty ()) {
+            JournalGroup group = m_redo.takeLast ();
+            replayJournalGroup (group, false);
+            m_undo.append (group);
+            emit journalChanged ();
+        }
+    }
+
+public: // JSON import implementation
+    int importJson (QQmlJsonStreamReader & reader, int batchSize = 500) Q_DECL_FINAL {
+        int ret = -1;
+        if (reader.tokenType () == QQmlJsonStreamReader::Invalid) {
+            reader.readNext ();
+        }
+        if (reader.tokenType () == QQmlJsonStreamReader::BeginArray) {
+            const bool local = (QThread::currentThread () == thread ());
+            const JournalPause pause (this, local); // NOTE : imported rows are loaded data, not edits to undo; from another thread, onHandoverReady () pauses it
+            QList<ItemType *> batch;
+            batch.reserve (qMax (batchSize, 1));
+            ret = 0;
+            bool done = false;
+            while (!done) {
+                switch (reader.readNext ()) {
+                    case QQmlJsonStreamReader::EndArray: {
+                        done = true;
+                        break;
+                    }
+                    case QQmlJsonStreamReader::BeginObject: {
+                        ItemType * item = (local ? acquire () : createItem ()); // NOTE : not referenced yet, so the writes don't reach the views
+                        if (item == Q_NULLPTR) { // NOTE : no factory and no default constructor
+                            ret  = -1;
+                            done = true;
+                            break;
+                        }
+                        batch.append (item);
+                        if (!importJsonObject (reader, item, batchSize)) { // NOTE : the half-filled item is dropped, the full ones are kept
+                            delete batch.takeLast ();
+                            ret  = -1;
+                            done = true;
+                        }
+                        else if (++ret % qMax (batchSize, 1) == 0) {
+                            flushImport (batch, local);
+                        }
+                        break;
+                    }
+                    case QQmlJsonStreamReader::EndDocument:
+                    case QQmlJsonStreamReader::Error: {
+                        ret  = -1;
+                        done = true;
+                        break;
+                    }
+                    default: { // NOTE : only objects can be items
+                        reader.skipCurrent ();
+                        break;
+                    }
+                }
+            }
+            flushImport (batch, local);
+        }
+        return ret;
+    }
+
+public: // snapshot blocks implementation
+    void writeSnapshot (QDataStream & stream) Q_DECL_FINAL {
+        if (dynamic_cast<SnapshotSource *> (m_pageSource.data ()) != Q_NULLPTR) { // NOTE : rows not decoded yet would be lost
+            while (canFetchMore (noParent ())) {
+                fetchMore (noParent ());
+            }
+        }
+        writeSnapshotBlock (stream, 0, m_items.count ());
+    }
+    bool readSnapshot (const QByteArray & data, bool lazy = false) Q_DECL_FINAL {
+        bool ret = false;
+        QDataStream stream (data);
+        stream.setVersion (snapshotStreamVersion ());
+        SnapshotLayout layout;
+        if (readSnapshotLayout (stream, layout)) {
+            QList<ItemType *> items;
+            items.reserve (int (qMin (layout.rowCount, quint32 (data.size ()))));
+            for (quint32 row = 0; row < layout.rowCount && stream.status () == QDataStream::Ok; row++) {
+                items.append (readSnapshotRow (stream, layout, lazy));
+            }
+            if (stream.status () == QDataStream::Ok) {
+                if (dynamic_cast<SnapshotSource *> (m_pageSource.data ()) != Q_NULLPTR) {
+                    m_pageSource.clear ();
+                }
+                {
+                    const JournalPause pause (this);
+                    beginBatch ();
+                    clear ();
+                    append (items);
+                    endBatch ();
+                }
+                clearJournal (); // NOTE : the steps recorded so far apply to the replaced content
+                ret = true;
+            }
+            else {
+                qDeleteAll (items);
+            }
+        }
+        return ret;
+    }
+    void deferSnapshot (const QByteArray & data) Q_DECL_FINAL {
+        {
+            const JournalPause pause (this);
+            clear ();
+        }
+        clearJournal ();
+        setPageSource (QSharedPointer<SnapshotSource>::create (this, data), (m_fetchChunk > 0 ? m_fetchChunk : 50));
+    }
+
+public: // content merge implementation
+    void syncFrom (QQmlObjectListModelBase * other) Q_DECL_FINAL { // NOTE : the items of the other model are moved here, or merged into the ones known for their UID
+        QQmlObjectListModel * source = dynamic_cast<QQmlObjectListModel *> (other);
+        if (source != Q_NULLPTR && source != this) {
+            const QList<ItemType *> items = source->m_items;
+            FOREACH_PTR_IN_QLIST (ItemType, item, items) {
+                if (item != Q_NULLPTR && item->parent () == source) {
+                    item->setParent (Q_NULLPTR); // NOTE : handed over, so the other model doesn't release it
+                }
+            }
+            source->clear ();
+            syncTo (items);
+        }
+    }
+
+public: // memory estimate implementation
+    qint64 estimatedBytes (void) const Q_DECL_FINAL {
+        qint64 ret = 0;
+        FOREACH_PTR_IN_QLIST (ItemType, item, m_items) {
+            ret += itemBytes (item);
+        }
+        return ret;
+    }
+
+public: // delta replication implementation
+    QByteArray snapshotRows (int first, int count) Q_DECL_FINAL {
+        QByteArray ret;
+        QDataStream stream (&ret, QIODevice::WriteOnly);
+        stream.setVersion (snapshotStreamVersion ());
+        first = qBound (0, first, m_items.count ());
+        writeSnapshotBlock (stream, first, qBound (0, count, m_items.count () - first));
+        return ret;
+    }
+    bool readRows (const QByteArray & data, int row) Q_DECL_FINAL {
+        bool ret = false;
+        QDataStream stream (data);
+        stream.setVersion (snapshotStreamVersion ());
+        SnapshotLayout layout;
+        if (row >= 0 && row <= m_items.count () && readSnapshotLayout (stream, layout)) {
+            QList<ItemType *> items;
+            items.reserve (int (qMin (layout.rowCount, quint32 (data.size ()))));
+            for (quint32 idx = 0; idx < layout.rowCount && stream.status () == QDataStream::Ok; idx++) {
+                items.append (readSnapshotRow (stream, layout, false));
+            }
+            if (stream.status () == QDataStream::Ok) {
+                insert (row, items);
+                ret = true;
+            }
+            else {
+                qDeleteAll (items);
+            }
+        }
+        return ret;
+    }
+    bool setRoleValue (int row, int role, const QVariant & value) Q_DECL_FINAL {
+        return setRoleValue (at (row), role, value);
+    }
+    int viewIndexOf (QObject * item) const Q_DECL_FINAL { // NOTE : during a batch, the row the views still know
+        ItemType * obj = qobject_cast<ItemType *> (item);
+        if (m_batchDepth > 0) {
+            if (m_batchViewRows.isEmpty () && !m_batchView.isEmpty ()) { // NOTE : built once per batch, the rows of the views don't change until it ends
+                m_batchViewRows.reserve (m_batchView.count ());
+                for (int row = m_batchView.count () -1; row >= 0; row--) {
+                    m_batchViewRows.insert (m_batchView.at (row), row);
+                }
+            }
+            return m_batchViewRows.value (obj, -1);
+        }
+        return indexOf (obj);
+    }
 
 protected: // internal stuff
     static const QString & emptyStr (void) {
@@ -630,70 +1797,843 @@ protected: // internal stuff
         return ret;
     }
     int rowCount (const QModelIndex & parent = QModelIndex ()) const Q_DECL_FINAL {
-        return (!parent.isValid () ? m_items.count () : 0);
+        return (!parent.isValid () ? viewItems ().count () : 0);
+    }
+    inline const QList<ItemType *> & viewItems (void) const { // the rows as currently known by the views
+        return (m_batchDepth > 0 ? m_batchView : m_items);
+    }
+    ItemType * viewAt (int row) const {
+        const QList<ItemType *> & rows = viewItems ();
+        return (row >= 0 && row < rows.count () ? rows.at (row) : Q_NULLPTR);
+    }
+    inline void beginInsertItems (int first, int last) {
+        if (isJournaling ()) { // NOTE : the inserted items are only captured if the insertion is undone
+            journalRecord (JournalEntry (JournalEntry::Insert, first, last - first +1));
+        }
+        if (m_batchDepth == 0) {
+            beginInsertRows (noParent (), first, last);
+        }
+    }
+    inline void endInsertItems (void) {
+        if (m_batchDepth == 0) {
+            updateCounter ();
+            endInsertRows ();
+        }
+    }
+    inline void beginRemoveItems (int first, int last) {
+        if (isJournaling ()) {
+            JournalEntry entry (JournalEntry::Remove, first, last - first +1);
+            entry.items = m_items.mid (first, entry.count);
+            journalRecord (entry);
+        }
+        if (m_batchDepth == 0) {
+            beginRemoveRows (noParent (), first, last);
+        }
+    }
+    inline void endRemoveItems (void) {
+        if (m_batchDepth == 0) {
+            updateCounter ();
+            endRemoveRows ();
+        }
+    }
+    void publishBatch (void) {
+        // NOTE : the views still know the rows as they were when the batch started,
+        // so replay the difference with the smallest set of row signals we can find cheaply
+        const QList<ItemType *> target = m_items;
+        m_items = m_batchView;
+        m_batchView.clear ();
+        m_batchViewRows.clear ();
+        if (m_items != target) {
+            QSet<ItemType *> oldItems;
+            QSet<ItemType *> newItems;
+            oldItems.reserve (m_items.count ());
+            newItems.reserve (target.count ());
+            for (typename QList<ItemType *>::const_iterator it = m_items.constBegin (); it != m_items.constEnd (); ++it) {
+                oldItems.insert (* it);
+            }
+            for (typename QList<ItemType *>::const_iterator it = target.constBegin (); it != target.constEnd (); ++it) {
+                newItems.insert (* it);
+            }
+            QList<QPair<int, int> > removedRuns;  // [first, last] in the old rows
+            QList<QPair<int, int> > insertedRuns; // [first, last] in the new rows
+            QList<ItemType *> oldKept;
+            QList<ItemType *> newKept;
+            collectRuns (m_items, newItems, removedRuns, oldKept);
+            collectRuns (target, oldItems, insertedRuns, newKept);
+            QVector<bool> inPlace (newKept.count (), true);
+            int movesCount = 0;
+            if (oldKept != newKept) {
+                // NOTE : the kept items that belong to the longest increasing subsequence of old positions
+                // stay where they are, only the other ones have to be moved (LCS of two permutations)
+                QHash<ItemType *, int> oldPos;
+                oldPos.reserve (oldKept.count ());
+                for (int idx = 0; idx < oldKept.count (); idx++) {
+                    oldPos.insert (oldKept.at (idx), idx);
+                }
+                QVector<int> sequence (newKept.count ());
+                for (int idx = 0; idx < newKept.count (); idx++) {
+                    sequence [idx] = oldPos.value (newKept.at (idx));
+                }
+                inPlace = longestIncreasingSubsequence (sequence);
+                movesCount = inPlace.count (false);
+            }
+            if (removedRuns.count () + insertedRuns.count () + movesCount > maxBatchRuns ()) {
+                beginResetModel ();
+                m_items = target;
+                endResetModel ();
+            }
+            else {
+                for (int idx = removedRuns.count () -1; idx >= 0; idx--) { // from the end, so the runs above stay valid
+                    const QPair<int, int> & run = removedRuns.at (idx);
+                    beginRemoveRows (noParent (), run.first, run.second);
+                    m_items.erase (m_items.begin () + run.first, m_items.begin () + run.second +1);
+                    endRemoveRows ();
+                }
+                for (int idx = 0; idx < newKept.count () && movesCount > 0; idx++) { // each moved item goes right after its new predecessor
+                    if (!inPlace.at (idx)) {
+                        const int from = m_items.indexOf (newKept.at (idx));
+                        const int dest = (idx > 0 ? m_items.indexOf (newKept.at (idx -1)) +1 : 0);
+                        if (from != dest && beginMoveRows (noParent (), from, from, noParent (), dest)) {
+                            m_items.move (from, (from < dest ? dest -1 : dest));
+                            endMoveRows ();
+                        }
+                        movesCount--;
+                    }
+                }
+                for (int idx = 0; idx < insertedRuns.count (); idx++) { // from the start, so the rows below are final
+                    const QPair<int, int> & run = insertedRuns.at (idx);
+                    const int len = (run.second - run.first +1);
+                    beginInsertRows (noParent (), run.first, run.second);
+                    if (run.first < m_items.count ()) {
+                        QList<ItemType *> rows;
+                        rows.reserve (m_items.count () + len);
+                        rows.append (m_items.mid (0, run.first));
+                        rows.append (target.mid (run.first, len));
+                        rows.append (m_items.mid (run.first));
+                        m_items = rows;
+                    }
+                    else {
+                        m_items.append (target.mid (run.first, len));
+                    }
+                    endInsertRows ();
+                }
+            }
+            m_items = target;
+            m_rowsDirtyFrom = 0;
+        }
+        flushPendingChanges ();
+        updateCounter ();
+    }
+    void replaceItems (const QList<ItemType *> & target, const QSet<ItemType *> & kept) { // NOTE : only in a batch, which replays the difference
+        FOREACH_PTR_IN_QLIST (ItemType, item, m_items) {
+            if (!kept.contains (item)) {
+                dereferenceItem (item);
+            }
+        }
+        m_items = target;
+        for (int row = 0; row < m_items.count (); row++) {
+            ItemType * item = m_items.at (row);
+            if (!m_rowByItem.contains (item)) {
+                referenceItem (item);
+            }
+            m_rowByItem.insert (item, row);
+        }
+        m_rowsDirtyFrom = INT_MAX;
+    }
+    static void collectRuns (const QList<ItemType *> & list, const QSet<ItemType *> & others, QList<QPair<int, int> > & runs, QList<ItemType *> & kept) {
+        for (int row = 0; row < list.count (); row++) {
+            ItemType * item = list.at (row);
+            if (!others.contains (item)) {
+                if (!runs.isEmpty () && runs.last ().second == row -1) {
+                    runs.last ().second = row;
+                }
+                else {
+                    runs.append (qMakePair (row, row));
+                }
+            }
+            else {
+                kept.append (item);
+            }
+        }
+    }
+    static QVector<bool> longestIncreasingSubsequence (const QVector<int> & sequence) {
+        QVector<int> tails; // index of the smallest tail for each subsequence length
+        QVector<int> previous (sequence.count (), -1);
+        for (int idx = 0; idx < sequence.count (); idx++) {
+            int low = 0;
+            int high = tails.count ();
+            while (low < high) {
+                const int mid = ((low + high) / 2);
+                if (sequence.at (tails.at (mid)) < sequence.at (idx)) {
+                    low = (mid +1);
+                }
+                else {
+                    high = mid;
+                }
+            }
+            if (low > 0) {
+                previous [idx] = tails.at (low -1);
+            }
+            if (low < tails.count ()) {
+                tails [low] = idx;
+            }
+            else {
+                tails.append (idx);
+            }
+        }
+        QVector<bool> ret (sequence.count (), false);
+        for (int idx = (!tails.isEmpty () ? tails.last () : -1); idx >= 0; idx = previous.at (idx)) {
+            ret [idx] = true;
+        }
+        return ret;
+    }
+    void copyRoles (ItemType * from, ItemType * to) const {
+        for (int idx = 1; idx < m_meta->propByRole.count (); idx++) {
+            const QMetaProperty & metaProp = m_meta->propByRole.at (idx);
+            if (metaProp.isValid ()) {
+                QQmlObjectListModelBase * nested = Q_NULLPTR;
+                QQmlObjectListModelBase * incoming = Q_NULLPTR;
+                if (QMetaType::typeFlags (metaProp.userType ()) & QMetaType::PointerToQObject) {
+                    nested   = nestedModel (metaProp, to);
+                    incoming = nestedModel (metaProp, from);
+                }
+                if (nested != Q_NULLPTR && incoming != Q_NULLPTR) { // NOTE : usually a CONSTANT role, its content is synced instead
+                    nested->syncFrom (incoming);
+                }
+                else if (metaProp.isWritable ()) {
+                    const QQmlFieldDescriptor * field = fieldForProperty (metaProp);
+                    if (field != Q_NULLPTR && field->copy != Q_NULLPTR) { // NOTE : typed copy, no QVariant
+                        field->copy (from, to);
+                    }
+                    else {
+                        writeProperty (metaProp, to, readProperty (metaProp, from));
+                    }
+                }
+            }
+        }
+    }
+    QQmlObjectListModelBase * nestedModel (const QMetaProperty & metaProp, ItemType * item) const {
+        return qobject_cast<QQmlObjectListModelBase *> (readProperty (metaProp, item).value<QObject *> ());
+    }
+    void writeSnapshotBlock (QDataStream & stream, int first, int count) { // the layout, then the rows [first, first + count)
+        SnapshotLayout layout;
+        for (int idx = 1; idx < m_meta->propByRole.count (); idx++) {
+            const QMetaProperty & metaProp = m_meta->propByRole.at (idx);
+            if (metaProp.isValid ()) {
+                if (QMetaType::typeFlags (metaProp.userType ()) & QMetaType::PointerToQObject) {
+                    layout.props.append (metaProp);
+                    layout.kinds.append (quint8 (SnapshotLayout::Nested));
+                }
+                else if (metaProp.isWritable ()) {
+                    layout.props.append (metaProp);
+                    layout.kinds.append (quint8 (SnapshotLayout::Value));
+                }
+            }
+        }
+        stream << quint32 (layout.props.count ());
+        for (int idx = 0; idx < layout.props.count (); idx++) {
+            stream << QByteArray (layout.props.at (idx).name ()) << layout.kinds.at (idx);
+        }
+        stream << quint32 (count);
+        for (int row = first; row < first + count; row++) {
+            ItemType * item = m_items.at (row);
+            for (int idx = 0; idx < layout.props.count (); idx++) {
+                const QMetaProperty & metaProp = layout.props.at (idx);
+                if (layout.kinds.at (idx) == SnapshotLayout::Value) {
+                    stream << readProperty (metaProp, item);
+                }
+                else {
+                    QByteArray block;
+                    if (QQmlObjectListModelBase * nested = nestedModel (metaProp, item)) {
+                        QDataStream sub (&block, QIODevice::WriteOnly);
+                        sub.setVersion (stream.version ());
+                        nested->writeSnapshot (sub);
+                    }
+                    stream << block;
+                }
+            }
+        }
+    }
+    bool readSnapshotLayout (QDataStream & stream, SnapshotLayout & layout) const {
+        quint32 roleCount = 0;
+        stream >> roleCount;
+        for (quint32 idx = 0; idx < roleCount && stream.status () == QDataStream::Ok; idx++) {
+            QByteArray name;
+            quint8 kind = 0;
+            stream >> name >> kind;
+            const int role = roleForName (name); // NOTE : roles removed since the snapshot are skipped
+            layout.props.append (role > baseRole () ? propertyForRole (role) : QMetaProperty ());
+            layout.kinds.append (kind);
+        }
+        stream >> layout.rowCount;
+        return (stream.status () == QDataStream::Ok);
+    }
+    ItemType * readSnapshotRow (QDataStream & stream, const SnapshotLayout & layout, bool lazy) {
+        ItemType * ret = acquire (); // NOTE : not referenced yet, so the writes don't reach the views
+        if (ret == Q_NULLPTR) { // NOTE : no factory and no default constructor, the block can't be decoded
+            stream.setStatus (QDataStream::ReadCorruptData);
+        }
+        for (int idx = 0; idx < layout.props.count () && ret != Q_NULLPTR; idx++) {
+            const QMetaProperty & metaProp = layout.props.at (idx);
+            if (layout.kinds.at (idx) == SnapshotLayout::Value) {
+                QVariant value;
+                stream >> value;
+                if (metaProp.isValid () && metaProp.isWritable ()) {
+                    writeProperty (metaProp, ret, value);
+                }
+            }
+            else {
+                QByteArray block;
+                stream >> block;
+                QQmlObjectListModelBase * nested = (metaProp.isValid () ? nestedModel (metaProp, ret) : Q_NULLPTR);
+                if (nested != Q_NULLPTR && !block.isEmpty ()) {
+                    if (lazy) {
+                        nested->deferSnapshot (block);
+                    }
+                    else {
+                        nested->readSnapshot (block, false);
+                    }
+                }
+            }
+        }
+        return ret;
+    }
+    bool importJsonObject (QQmlJsonStreamReader & reader, ItemType * item, int batchSize) {
+        forever {
+            const QQmlJsonStreamReader::TokenType token = reader.readNext ();
+            if (token == QQmlJsonStreamReader::EndObject) {
+                return true;
+            }
+            else if (token != QQmlJsonStreamReader::Name) {
+                return false;
+            }
+            const int role = roleForName (reader.name ().toUtf8 ());
+            const QMetaProperty metaProp = (role > baseRole () ? propertyForRole (role) : QMetaProperty ());
+            switch (reader.readNext ()) {
+                case QQmlJsonStreamReader::Value: {
+                    if (metaProp.isValid () && metaProp.isWritable ()) {
+                        writeProperty (metaProp, item, reader.value ());
+                    }
+                    break;
+                }
+                case QQmlJsonStreamReader::BeginArray: {
+                    QQmlObjectListModelBase * nested = (metaProp.isValid () ? nestedModel (metaProp, item) : Q_NULLPTR);
+                    if (nested != Q_NULLPTR) {
+                        if (nested->importJson (reader, batchSize) < 0) {
+                            return false;
+                        }
+                    }
+                    else {
+                        reader.skipCurrent ();
+                    }
+                    break;
+                }
+                case QQmlJsonStreamReader::BeginObject: {
+                    reader.skipCurrent ();
+                    break;
+                }
+                default: {
+                    return false;
+                }
+            }
+        }
+    }
+    void flushImport (QList<ItemType *> & batch, bool local) {
+        if (!batch.isEmpty ()) {
+            if (local) {
+                append (batch);
+            }
+            else {
+                postAppend (batch);
+            }
+            batch.clear ();
+        }
+    }
+    template<typename T> static typename std::enable_if<std::is_default_constructible<T>::value, T *>::type defaultItem (void) {
+        return new T ();
+    }
+    template<typename T> static typename std::enable_if<!std::is_default_constructible<T>::value, T *>::type defaultItem (void) {
+        return Q_NULLPTR; // NOTE : only a factory can build these, see setItemFactory ()
+    }
+    static int maxBatchRuns (void) { // above that, a single reset is cheaper than replaying each run
+        static const int ret = 32;
+        return ret;
+    }
+    const QMetaProperty & propertyForRole (int role) const { // role -> property dispatch, no name lookup
+        static const QMetaProperty INVALID = QMetaProperty ();
+        const int idx = (role != Qt::DisplayRole ? role - baseRole () : -1);
+        if (idx > 0 && idx < m_meta->propByRole.size ()) {
+            return m_meta->propByRole.at (idx);
+        }
+        return (role == Qt::DisplayRole ? m_meta->dispProp : INVALID);
+    }
+    const QQmlFieldDescriptor * fieldForProperty (const QMetaProperty & metaProp) const {
+        const int idx = (metaProp.propertyIndex () +1); // NOTE : same index as in propByRole
+        return (idx > 0 && idx < m_meta->fieldByRole.size () ? m_meta->fieldByRole.at (idx) : Q_NULLPTR);
+    }
+    QVariant readProperty (const QMetaProperty & metaProp, ItemType * item) const { // direct getter call for the properties made by the helper macros
+        const QQmlFieldDescriptor * field = fieldForProperty (metaProp);
+        return (field != Q_NULLPTR ? field->read (item) : metaProp.read (item));
+    }
+    bool writeProperty (const QMetaProperty & metaProp, ItemType * item, const QVariant & value) const {
+        const QQmlFieldDescriptor * field = fieldForProperty (metaProp);
+        return (field != Q_NULLPTR && field->write != Q_NULLPTR ? field->write (item, value) : metaProp.write (item, value));
     }
     void referenceItem (ItemType * item) {
+        QQML_OBJMODEL_STAT (const QQmlObjectListModelStats::ScopedTimer statTimer (stats (), QQmlObjectListModelStats::ReferenceItem);)
         if (item != Q_NULLPTR) {
             if (!item->parent ()) {
                 item->setParent (this);
             }
-            for (QHash<int, int>::const_iterator it = m_signalIdxToRole.constBegin (); it != m_signalIdxToRole.constEnd (); ++it) {
-                connect (item, item->metaObject ()->method (it.key ()), this, m_handler, Qt::UniqueConnection);
-            }
-            if (!m_uidRoleName.isEmpty ()) {
-                const QString key = m_indexByUid.key (item, emptyStr ());
-                if (!key.isEmpty ()) {
-                    m_indexByUid.remove (key);
-                }
-                const QString value = item->property (m_uidRoleName).toString ();
-                if (!value.isEmpty ()) {
-                    m_indexByUid.insert (value, item);
+            m_graveyard.remove (item); // NOTE : removed and added back before being released
+            if (!qQmlAttachObserver (item, this)) { // NOTE : fallback for the items without QML_OBSERVABLE
+                for (QHash<int, int>::const_iterator it = m_meta->signalIdxToRole.constBegin (); it != m_meta->signalIdxToRole.constEnd (); ++it) {
+                    connect (item, item->metaObject ()->method (it.key ()), this, m_meta->handler, Qt::UniqueConnection);
                 }
             }
+            if (m_meta->uidProp.isValid ()) {
+                indexUid (item);
+            }
+            for (typename QHash<int, SecondaryIndex>::iterator it = m_indexes.begin (); it != m_indexes.end (); ++it) {
+                indexItem (it.value (), item);
+            }
         }
     }
     void dereferenceItem (ItemType * item) {
         if (item != Q_NULLPTR) {
-            disconnect (this, Q_NULLPTR, item, Q_NULLPTR);
-            disconnect (item, Q_NULLPTR, this, Q_NULLPTR);
-            if (!m_uidRoleName.isEmpty ()) {
-                const QString key = m_indexByUid.key (item, emptyStr ());
-                if (!key.isEmpty ()) {
-                    m_indexByUid.remove (key);
-                }
+            if (!qQmlDetachObserver (item, this)) {
+                disconnect (this, Q_NULLPTR, item, Q_NULLPTR);
+                disconnect (item, Q_NULLPTR, this, Q_NULLPTR);
+            }
+            m_rowByItem.remove (item);
+            m_dirtyItems.remove (item);
+            if (m_meta->uidProp.isValid ()) {
+                unindexUid (item);
+            }
+            for (typename QHash<int, SecondaryIndex>::iterator it = m_indexes.begin (); it != m_indexes.end (); ++it) {
+                unindexItem (it.value (), item);
             }
             if (item->parent () == this) { // FIXME : maybe that's not the best way to test ownership ?
-                item->deleteLater ();
+                m_graveyard.insert (item);
+                scheduleRelease ();
             }
         }
     }
     void onItemPropertyChanged (void) Q_DECL_FINAL {
-        ItemType * item = qobject_cast<ItemType *> (sender ());
-        const int row = m_items.indexOf (item);
-        const int sig = senderSignalIndex ();
-        const int role = m_signalIdxToRole.value (sig, -1);
+        handleItemPropertyChanged (qobject_cast<ItemType *> (sender ()), senderSignalIndex (), Q_NULLPTR);
+    }
+    void itemPropertyChanged (QObject * item, int signalIdx, const QQmlOldValue & oldValue) Q_DECL_FINAL { // called by the QML_OBSERVABLE items
+        handleItemPropertyChanged (static_cast<ItemType *> (item), signalIdx, &oldValue);
+    }
+    void handleItemPropertyChanged (ItemType * item, int sig, const QQmlOldValue * oldValue) {
+        QQML_OBJMODEL_STAT (const QQmlObjectListModelStats::ScopedTimer statTimer (stats (), QQmlObjectListModelStats::PropertyChanged);)
+        const int row = indexOf (item);
+        const int role = m_meta->signalIdxToRole.value (sig, -1);
         if (row >= 0 && role >= 0) {
-            const QModelIndex index = QAbstractListModel::index (row, 0, noParent ());
+            if (m_coalescing || m_batchDepth > 0) {
+                m_dirtyItems.insert (item);
+                m_dirtyRoles.insert (role);
+                if (role == m_meta->dispRole) {
+                    m_dirtyRoles.insert (Qt::DisplayRole);
+                }
+                if (m_batchDepth == 0) {
+                    scheduleFlush ();
+                }
+            }
+            else {
+                const QModelIndex index = QAbstractListModel::index (row, 0, noParent ());
+                QVector<int> rolesList;
+                rolesList.append (role);
+                if (role == m_meta->dispRole) {
+                    rolesList.append (Qt::DisplayRole);
+                }
+                emit dataChanged (index, index, rolesList);
+            }
+        }
+        if (role > baseRole () && row >= 0 && oldValue != Q_NULLPTR && isJournaling ()) {
+            journalProperty (item, role, oldValue->toVariant ());
+        }
+        if (role >= 0 && role == m_meta->uidRole && row >= 0) {
+            indexUid (item);
+        }
+        if (!m_indexes.isEmpty () && row >= 0) {
+            typename QHash<int, SecondaryIndex>::iterator it = m_indexes.find (role);
+            if (it != m_indexes.end ()) {
+                indexItem (it.value (), item);
+            }
+        }
+    }
+    void indexItem (SecondaryIndex & index, ItemType * item) {
+        unindexItem (index, item);
+        const QString key = readProperty (index.prop, item).toString ();
+        index.itemsByKey.insert (key, item); // NOTE : the latest holder comes first, the previous ones take over when it goes
+        index.keyByItem.insert (item, key);
+    }
+    void unindexItem (SecondaryIndex & index, ItemType * item) {
+        typename QHash<ItemType *, QString>::iterator it = index.keyByItem.find (item);
+        if (it != index.keyByItem.end ()) {
+            index.itemsByKey.remove (it.value (), item);
+            index.keyByItem.erase (it);
+        }
+    }
+    void flushPendingChanges (void) Q_DECL_FINAL {
+        m_flushQueued = false;
+        if (!m_dirtyItems.isEmpty () && m_batchDepth == 0) { // NOTE : a running batch flushes them when it ends
+            QVector<int> rows;
+            rows.reserve (m_dirtyItems.count ());
+            for (typename QSet<ItemType *>::const_iterator it = m_dirtyItems.constBegin (); it != m_dirtyItems.constEnd (); ++it) {
+                const int row = indexOf (* it);
+                if (row >= 0) {
+                    rows.append (row);
+                }
+            }
             QVector<int> rolesList;
-            rolesList.append (role);
-            if (m_roles.value (role) == m_dispRoleName) {
-                rolesList.append (Qt::DisplayRole);
+            rolesList.reserve (m_dirtyRoles.count ());
+            for (QSet<int>::const_iterator it = m_dirtyRoles.constBegin (); it != m_dirtyRoles.constEnd (); ++it) {
+                rolesList.append (* it);
+            }
+            m_dirtyItems.clear ();
+            m_dirtyRoles.clear ();
+            std::sort (rows.begin (), rows.end ());
+            for (int first = 0, idx = 1; idx <= rows.count (); idx++) { // one signal per contiguous run of rows
+                if (idx == rows.count () || rows.at (idx) != rows.at (idx -1) +1) {
+                    emit dataChanged (QAbstractListModel::index (rows.at (first), 0, noParent ()),
+                                      QAbstractListModel::index (rows.at (idx -1), 0, noParent ()),
+                                      rolesList);
+                    first = idx;
+                }
+            }
+        }
+    }
+    void onHandoverReady (void) Q_DECL_FINAL {
+        QList<ItemType *> handover;
+        {
+            QMutexLocker locker (&m_handoverMutex);
+            handover.swap (m_handover);
+        }
+        const JournalPause pause (this); // NOTE : only postAppend () and background imports hand items over
+        append (handover);
+    }
+    void releaseItems (void) Q_DECL_FINAL {
+        m_releaseQueued = false;
+        if (!m_graveyard.isEmpty () && m_batchDepth == 0) { // NOTE : a running batch can still show them, it reschedules when it ends
+            QSet<ItemType *> graveyard;
+            graveyard.swap (m_graveyard);
+            for (typename QSet<ItemType *>::const_iterator it = graveyard.constBegin (); it != graveyard.constEnd (); ++it) {
+                ItemType * item = (* it);
+                if (item->parent () == this && !m_journalRefs.contains (item)) { // NOTE : the journal puts them back when it forgets them
+                    if (!recycleItem (item)) {
+                        delete item;
+                    }
+                }
+            }
+        }
+    }
+    bool recycleItem (ItemType * item) { // resets the item and puts it in the shared pool, if there is room
+        ItemPool & pool = itemPool ();
+        Reset reset;
+        QVector<QPair<QMetaProperty, QVariant> > defaults;
+        {
+            QMutexLocker locker (&pool.mutex);
+            if (pool.items.count () >= pool.capacity) {
+                return false;
+            }
+            reset    = pool.reset;
+            defaults = pool.defaults;
+        }
+        item->setParent (Q_NULLPTR); // NOTE : can outlive this model
+        item->disconnect (); // NOTE : nothing should still listen to a pooled item
+        if (reset) {
+            reset (item);
+        }
+        else {
+            for (typename QVector<QPair<QMetaProperty, QVariant> >::const_iterator it = defaults.constBegin (); it != defaults.constEnd (); ++it) {
+                writeProperty (it->first, item, it->second);
+            }
+        }
+        QMutexLocker locker (&pool.mutex);
+        const bool ret = (pool.items.count () < pool.capacity);
+        if (ret) {
+            pool.items.append (item);
+        }
+        return ret;
+    }
+    void scheduleRelease (void) {
+        if (!m_releaseQueued) {
+            m_releaseQueued = true;
+            QMetaObject::invokeMethod (this, "releaseItems", Qt::QueuedConnection);
+        }
+    }
+    void scheduleFlush (void) {
+        if (!m_flushQueued) {
+            m_flushQueued = true;
+            QMetaObject::invokeMethod (this, "flushPendingChanges", Qt::QueuedConnection);
+        }
+    }
+    inline bool isJournaling (void) const {
+        return (m_journaling && !m_journalReplaying && m_journalPaused == 0);
+    }
+    void journalRecord (const JournalEntry & entry) {
+        if (!m_redo.isEmpty ()) { // a new change forks the history
+            dropJournalGroups (m_redo, m_redo.count ());
+            emit journalChanged ();
+        }
+        retainJournalEntry (entry, +1);
+        m_journalOpen.append (entry);
+        m_journalOpen.last ().bytes = entryBytes (entry);
+        m_journalBytes += m_journalOpen.last ().bytes;
+        if (m_batchDepth == 0) {
+            closeJournalGroup ();
+        }
+    }
+    void journalReplace (const QList<ItemType *> & before) {
+        if (isJournaling () && m_items != before) {
+            JournalEntry entry (JournalEntry::Replace, 0, before.count ());
+            entry.items  = before;
+            entry.others = m_items;
+            journalRecord (entry);
+        }
+    }
+    void journalProperty (ItemType * item, int role, const QVariant & oldValue) {
+        const QMetaProperty & metaProp = propertyForRole (role);
+        if (metaProp.isValid () && metaProp.isWritable ()) {
+            const QVariant value = readProperty (metaProp, item);
+            if (value != oldValue) {
+                JournalEntry entry (JournalEntry::SetProperty, -1, 1);
+                entry.role     = role;
+                entry.oldValue = oldValue;
+                entry.newValue = value;
+                entry.items.append (item);
+                journalRecord (entry);
+            }
+        }
+    }
+    void closeJournalGroup (void) {
+        if (!m_journalOpen.isEmpty ()) {
+            m_undo.append (m_journalOpen);
+            m_journalOpen.clear ();
+            trimJournal ();
+            emit journalChanged ();
+        }
+    }
+    bool trimJournal (void) { // drops the oldest steps until the journal fits in its budget
+        int count = 0;
+        for (qint64 bytes = m_journalBytes; bytes > m_journalMaxBytes && count < m_undo.count (); count++) {
+            for (typename JournalGroup::const_iterator it = m_undo.at (count).constBegin (); it != m_undo.at (count).constEnd (); ++it) {
+                bytes -= it->bytes;
+            }
+        }
+        dropJournalGroups (m_undo, count);
+        return (count > 0);
+    }
+    void dropJournalGroups (QList<JournalGroup> & groups, int count) { // the oldest ones
+        for (int idx = 0; idx < count; idx++) {
+            dropJournalEntries (groups [idx]);
+        }
+        groups.erase (groups.begin (), groups.begin () + count);
+    }
+    void dropJournalEntries (JournalGroup & group) {
+        for (typename JournalGroup::const_iterator it = group.constBegin (); it != group.constEnd (); ++it) {
+            m_journalBytes -= it->bytes;
+            retainJournalEntry (* it, -1);
+        }
+        group.clear ();
+    }
+    void retainJournalEntry (const JournalEntry & entry, int delta) { // keeps alive the owned items the journal can put back
+        FOREACH_PTR_IN_QLIST (ItemType, item, entry.items) {
+            retainItem (item, delta);
+        }
+        FOREACH_PTR_IN_QLIST (ItemType, item, entry.others) {
+            retainItem (item, delta);
+        }
+    }
+    void retainItem (ItemType * item, int delta) {
+        int & refs = m_journalRefs [item];
+        refs += delta;
+        if (refs <= 0) {
+            m_journalRefs.remove (item);
+            if (!m_rowByItem.contains (item) && item->parent () == this) {
+                m_graveyard.insert (item);
+                scheduleRelease ();
+            }
+        }
+    }
+    qint64 entryBytes (const JournalEntry & entry) const { // a rough estimate, enough for the budget
+        qint64 ret = (qint64 (sizeof (JournalEntry))
+                      + qint64 (entry.items.count () + entry.others.count ()) * qint64 (sizeof (void *))
+                      + variantCost (entry.oldValue)
+                      + variantCost (entry.newValue));
+        switch (entry.type) {
+            case JournalEntry::Insert:
+            case JournalEntry::Remove: { // NOTE : the items kept alive for the step, with their nested models
+                FOREACH_PTR_IN_QLIST (ItemType, item, entry.items) {
+                    if (item != Q_NULLPTR && item->parent () == this) {
+                        ret += itemBytes (item);
+                    }
+                }
+                break;
+            }
+            case JournalEntry::Replace: { // NOTE : only the items on one side of the step are out of the model
+                QSet<ItemType *> before;
+                before.reserve (entry.items.count ());
+                FOREACH_PTR_IN_QLIST (ItemType, item, entry.items) {
+                    before.insert (item);
+                }
+                QSet<ItemType *> after;
+                after.reserve (entry.others.count ());
+                FOREACH_PTR_IN_QLIST (ItemType, item, entry.others) {
+                    after.insert (item);
+                    if (item != Q_NULLPTR && !before.contains (item) && item->parent () == this) {
+                        ret += itemBytes (item);
+                    }
+                }
+                FOREACH_PTR_IN_QLIST (ItemType, item, entry.items) {
+                    if (item != Q_NULLPTR && !after.contains (item) && item->parent () == this) {
+                        ret += itemBytes (item);
+                    }
+                }
+                break;
+            }
+            default: {
+                break;
             }
-            emit dataChanged (index, index, rolesList);
         }
-        if (!m_uidRoleName.isEmpty ()) {
-            const QByteArray roleName = m_roles.value (role, emptyBA ());
-            if (!roleName.isEmpty () && roleName == m_uidRoleName) {
-                const QString key = m_indexByUid.key (item, emptyStr ());
-                if (!key.isEmpty ()) {
-                    m_indexByUid.remove (key);
+        return ret;
+    }
+    qint64 itemBytes (ItemType * item) const { // a rough estimate of the memory held by an item
+        qint64 ret = qint64 (sizeof (ItemType));
+        for (int idx = 1; idx < m_meta->propByRole.count (); idx++) {
+            const QMetaProperty & metaProp = m_meta->propByRole.at (idx);
+            if (metaProp.isValid ()) {
+                if (QMetaType::typeFlags (metaProp.userType ()) & QMetaType::PointerToQObject) {
+                    if (QQmlObjectListModelBase * nested = nestedModel (metaProp, item)) {
+                        ret += nested->estimatedBytes ();
+                    }
+                }
+                else {
+                    ret += variantCost (readProperty (metaProp, item));
+                }
+            }
+        }
+        return ret;
+    }
+    static qint64 variantCost (const QVariant & value) {
+        switch (value.userType ()) {
+            case QMetaType::QString:    return (qint64 (value.toString ().size ()) * qint64 (sizeof (QChar)));
+            case QMetaType::QByteArray: return qint64 (value.toByteArray ().size ());
+            default:                    return 0;
+        }
+    }
+    void replayJournalGroup (JournalGroup & group, bool backward) { // as one batch, without journaling it again
+        m_journalReplaying = true;
+        beginBatch ();
+        for (int step = 0; step < group.count (); step++) {
+            JournalEntry & entry = group [backward ? group.count () - step -1 : step];
+            switch (entry.type) {
+                case JournalEntry::Insert: {
+                    if (backward) {
+                        if (entry.items.isEmpty ()) { // captured on first undo, then kept for redo
+                            m_journalBytes -= entry.bytes;
+                            entry.items = m_items.mid (entry.row, entry.count);
+                            retainJournalEntry (entry, +1);
+                            entry.bytes = entryBytes (entry);
+                            m_journalBytes += entry.bytes;
+                        }
+                        removeRange (entry.row, entry.count);
+                    }
+                    else {
+                        insert (entry.row, entry.items);
+                    }
+                    break;
+                }
+                case JournalEntry::Remove: {
+                    if (backward) {
+                        insert (entry.row, entry.items);
+                    }
+                    else {
+                        removeRange (entry.row, entry.count);
+                    }
+                    break;
+                }
+                case JournalEntry::Move: {
+                    if (backward) {
+                        moveRange (entry.pos, entry.count, entry.row);
+                    }
+                    else {
+                        moveRange (entry.row, entry.count, entry.pos);
+                    }
+                    break;
+                }
+                case JournalEntry::SetProperty: {
+                    const QMetaProperty & metaProp = propertyForRole (entry.role);
+                    if (metaProp.isValid () && !entry.items.isEmpty ()) {
+                        writeProperty (metaProp, entry.items.first (), (backward ? entry.oldValue : entry.newValue));
+                    }
+                    break;
                 }
-                const QString value = item->property (m_uidRoleName).toString ();
-                if (!value.isEmpty ()) {
-                    m_indexByUid.insert (value, item);
+                case JournalEntry::Replace: {
+                    const QList<ItemType *> & target = (backward ? entry.items : entry.others);
+                    QSet<ItemType *> kept;
+                    kept.reserve (target.count ());
+                    FOREACH_PTR_IN_QLIST (ItemType, item, target) {
+                        kept.insert (item);
+                    }
+                    replaceItems (target, kept);
+                    break;
                 }
             }
         }
+        endBatch ();
+        m_journalReplaying = false;
+    }
+    void indexUid (ItemType * item) {
+        unindexUid (item);
+        const QString key = readProperty (m_meta->uidProp, item).toString ();
+        if (!key.isEmpty ()) {
+            m_indexByUid.insert (key, item);
+            m_uidByItem.insert (item, key);
+        }
+    }
+    void unindexUid (ItemType * item) { // uses the reverse map, no scan of the UID index
+        typename QHash<ItemType *, QString>::iterator it = m_uidByItem.find (item);
+        if (it != m_uidByItem.end ()) {
+            typename QHash<QString, ItemType *>::iterator uidIt = m_indexByUid.find (it.value ());
+            if (uidIt != m_indexByUid.end () && uidIt.value () == item) {
+                m_indexByUid.erase (uidIt);
+            }
+            m_uidByItem.erase (it);
+        }
+    }
+    void indexInsertedRows (int idx, int count) {
+        for (int row = idx; row < idx + count; row++) {
+            if (ItemType * item = m_items.at (row)) {
+                m_rowByItem.insert (item, row);
+            }
+        }
+        if (idx + count < m_items.count ()) { // the following rows were shifted
+            invalidateRows (idx);
+        }
+    }
+    inline void invalidateRows (int from) { // rows of the items after 'from' are renumbered lazily
+        if (from < m_items.count () && from < m_rowsDirtyFrom) {
+            m_rowsDirtyFrom = from;
+        }
+    }
+    void reindexRows (void) const {
+        for (int row = m_rowsDirtyFrom; row < m_items.count (); row++) {
+            typename QHash<ItemType *, int>::iterator it = m_rowByItem.find (m_items.at (row));
+            if (it != m_rowByItem.end ()) { // NOTE : only items referenced by the model are indexed
+                it.value () = row;
+            }
+        }
+        m_rowsDirtyFrom = INT_MAX;
+    }
+    static ItemPool & itemPool (void) {
+        static ItemPool ret;
+        return ret;
+    }
+    static const RoleTable * roleTable (const QByteArray & displayRole, const QByteArray & uidRole) {
+        return RoleTable::get (displayRole, uidRole);
     }
     inline void updateCounter (void) {
         if (m_count != m_items.count ()) {
@@ -702,16 +2642,181 @@ protected: // internal stuff
         }
     }
 
+private: // item pool
+    struct ItemPool { // shared by all the models of the item type
+        ItemPool (void) : capacity (0), defaultsKnown (false) { }
+        ~ItemPool (void) {
+            qDeleteAll (items);
+        }
+        QMutex                                   mutex;
+        QList<ItemType *>                        items; // reset, and owned by no model
+        int                                      capacity;
+        Reset                                    reset;
+        bool                                     defaultsKnown;
+        QVector<QPair<QMetaProperty, QVariant> > defaults;
+    };
+
+private: // snapshots
+    struct SnapshotLayout {
+        enum Kind {
+            Value  = 0,
+            Nested = 1,
+        };
+        SnapshotLayout (void) : rowCount (0) { }
+        QVector<QMetaProperty> props; // invalid for roles unknown to this item type
+        QVector<quint8>        kinds;
+        quint32                rowCount;
+    };
+    class SnapshotSource : public QQmlObjectListModelSource<ItemType> { // decodes the rows of a block on demand
+    public:
+        explicit SnapshotSource (QQmlObjectListModel * model, const QByteArray & data)
+            : m_model (model)
+            , m_data (data)
+            , m_stream (m_data)
+            , m_next (0)
+        {
+            m_stream.setVersion (snapshotStreamVersion ());
+            if (!m_model->readSnapshotLayout (m_stream, m_layout)) {
+                m_layout.rowCount = 0;
+            }
+        }
+        bool hasMore (void) const {
+            return (m_next < m_layout.rowCount && m_stream.status () == QDataStream::Ok);
+        }
+        QList<ItemType *> fetch (int count) {
+            QList<ItemType *> ret;
+            for (; count > 0 && hasMore (); count--, m_next++) {
+                if (ItemType * item = m_model->readSnapshotRow (m_stream, m_layout, true)) {
+                    ret.append (item);
+                }
+            }
+            return ret;
+        }
+
+    private:
+        Q_DISABLE_COPY (SnapshotSource)
+        QQmlObjectListModel * m_model;
+        QByteArray            m_data;
+        QDataStream           m_stream;
+        SnapshotLayout        m_layout;
+        quint32               m_next;
+    };
+
+private: // queued mutations
+    struct Mutation {
+        enum Type {
+            Insert,
+            Remove,
+            SetProperty,
+        };
+        explicit Mutation (Type t = Insert, ItemType * i = Q_NULLPTR, const QString & u = QString (), int idx = -1, const QVariant & v = QVariant ())
+            : type (t)
+            , item   (t == Insert ? i : Q_NULLPTR)
+            , target (t != Insert ? i : Q_NULLPTR)
+            , uid (u)
+            , index (idx)
+            , value (v)
+            , stamp (QDeadlineTimer::current (Qt::PreciseTimer).deadlineNSecs ())
+        { }
+        Type               type;
+        ItemType *         item;   // Insert, owned by the queue until drained
+        QPointer<ItemType> target; // Remove and SetProperty, cleared if the item is deleted before the drain
+        QString            uid;
+        int                index; // row for Insert, role for SetProperty
+        QVariant           value;
+        qint64             stamp;
+    };
+
+private: // undo journal
+    struct JournalEntry {
+        enum Type {
+            Insert,
+            Remove,
+            Move,
+            SetProperty,
+            Replace,
+        };
+        explicit JournalEntry (Type t = Insert, int r = -1, int c = 0)
+            : type (t)
+            , row (r)
+            , count (c)
+            , pos (-1)
+            , role (-1)
+            , bytes (0)
+        { }
+        Type              type;
+        int               row;   // first row for Insert, Remove and Move
+        int               count; // number of rows for Insert, Remove and Move
+        int               pos;   // destination row for Move
+        int               role;  // for SetProperty
+        QList<ItemType *> items; // inserted or removed items, changed item, or old content for Replace
+        QList<ItemType *> others; // new content for Replace
+        QVariant          oldValue;
+        QVariant          newValue;
+        qint64            bytes; // estimated once when recorded, see entryBytes ()
+    };
+
+    class JournalPause { // leaves the changes made in its scope out of the journal
+    public:
+        explicit JournalPause (QQmlObjectListModel * model, bool active = true) : m_model (active ? model : Q_NULLPTR) {
+            if (m_model != Q_NULLPTR) { // NOTE : the counter is only touched from the model's thread
+                m_model->m_journalPaused++;
+            }
+        }
+        ~JournalPause (void) {
+            if (m_model != Q_NULLPTR) {
+                m_model->m_journalPaused--;
+            }
+        }
+
+    private:
+        QQmlObjectListModel * m_model;
+    };
+
+private: // secondary indexes
+    struct SecondaryIndex {
+        bool                            unique;
+        QMetaProperty                   prop;
+        QMultiHash<QString, ItemType *> itemsByKey;
+        QHash<ItemType *, QString>      keyByItem;
+    };
+
 private: // data members
     int                        m_count;
-    QByteArray                 m_uidRoleName;
-    QByteArray                 m_dispRoleName;
-    QMetaObject                m_metaObj;
-    QMetaMethod                m_handler;
-    QHash<int, QByteArray>     m_roles;
-    QHash<int, int>            m_signalIdxToRole;
+    int                        m_batchDepth;
+    bool                       m_coalescing;
+    bool                       m_flushQueued;
+    const RoleTable *          m_meta;
     QList<ItemType *>          m_items;
+    QList<ItemType *>          m_batchView;
+    mutable QHash<ItemType *, int> m_batchViewRows; // see viewIndexOf ()
+    mutable int                m_rowsDirtyFrom;
+    mutable QHash<ItemType *, int> m_rowByItem;
     QHash<QString, ItemType *> m_indexByUid;
+    QHash<ItemType *, QString> m_uidByItem;
+    QHash<int, SecondaryIndex> m_indexes;
+    QSet<ItemType *>           m_dirtyItems;
+    QSet<int>                  m_dirtyRoles;
+    QMutex                     m_handoverMutex;
+    QList<ItemType *>          m_handover;
+    QQmlMpscQueue<Mutation>    m_mutations;
+    QTimer *                   m_drainTimer;
+    int                        m_drainBudget;
+    qint64                     m_drainLatency;
+    QSharedPointer<QQmlObjectListModelSource<ItemType> > m_pageSource;
+    int                        m_fetchChunk;
+    bool                       m_releaseQueued;
+    QSet<ItemType *>           m_graveyard;
+    Factory                    m_factory;
+    bool                       m_journaling;
+    bool                       m_journalReplaying;
+    int                        m_journalPaused;
+    qint64                     m_journalMaxBytes;
+    qint64                     m_journalBytes;
+    JournalGroup               m_journalOpen;
+    QList<JournalGroup>        m_undo;
+    QList<JournalGroup>        m_redo;
+    QHash<ItemType *, int>     m_journalRefs;
 };
 
 #define QML_OBJMODEL_PROPERTY(type, name) \
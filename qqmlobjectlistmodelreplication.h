@@ -0,0 +1,513 @@
+#ifndef QQMLOBJECTLISTMODELREPLICATION_H
+#define QQMLOBJECTLISTMODELREPLICATION_H
+
+/*!
+    \class QQmlObjectListModelPublisher
+
+    \ingroup QT_QML_MODELS
+
+    \brief Streams the changes of a QQmlObjectListModel, and of the models nested in its items, to other processes
+
+    The publisher listens on a local socket (see \c QLocalServer). Each new client first receives
+    a snapshot of the whole tree of models, in the format of \c saveSnapshot(), then only the
+    changes : inserted rows (encoded like a snapshot), removed and moved ranges, and the new
+    values of the changed roles. Nested models are addressed by their path from the root model
+    (row of the item and role holding the nested model, at each level), and role names are sent
+    once per connection, then referred to by a short identifier.
+
+    The changes are recorded from the model signals, so batches and coalescing already reduce
+    what has to be sent. They are buffered and written as one frame per event-loop iteration.
+
+    The models are only watched while at least one client is connected, so an idle publisher
+    costs nothing. \c listen() fails if another publisher answers on that name, and only takes
+    over the socket left behind by one that crashed.
+
+    Example in use :
+    \code
+        QQmlObjectListModelPublisher * publisher = new QQmlObjectListModelPublisher (model, this);
+        publisher->listen ("my-model");
+    \endcode
+
+    \sa QQmlObjectListModelReplica
+*/
+
+/*!
+    \class QQmlObjectListModelReplica
+
+    \ingroup QT_QML_MODELS
+
+    \brief Mirrors in a QQmlObjectListModel the content of a model published by another process
+
+    The replica model must have the same item type as the published one (roles unknown to it are
+    skipped). Each received frame is applied in a batch on every model it touches, so the views
+    of the replica get one signal per run of changed rows.
+
+    Example in use :
+    \code
+        QQmlObjectListModelReplica * replica = new QQmlObjectListModelReplica (model, this);
+        replica->connectToPublisher ("my-model");
+    \endcode
+
+    \sa QQmlObjectListModelPublisher
+*/
+
+
+#include <QByteArray>
+#include <QBuffer>
+#include <QDataStream>
+#include <QDebug>
+#include <QHash>
+#include <QList>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMetaProperty>
+#include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QVariant>
+#include <QVector>
+#include <QtEndian>
+
+#include "qqmlobjectlistmodel.h"
+
+class QQmlObjectListModelPublisher : public QObject {
+    Q_OBJECT
+
+public:
+    enum RecordType {
+        DefineRole = 1, // id, name
+        Snapshot,       // block of the root model
+        Insert,         // path, row, block of the rows
+        Remove,         // path, row, count
+        Move,           // path, row, count, destination row
+        SetData,        // path, row, count, (role id, value) * count
+        Reset,          // path, block of the model
+    };
+
+    static QDataStream::Version streamVersion (void) {
+        return QDataStream::Qt_5_6;
+    }
+    static void writeFrame (QIODevice * device, const QByteArray & frame) { // length-prefixed
+        uchar header [4];
+        qToBigEndian<quint32> (quint32 (frame.size ()), header);
+        device->write (reinterpret_cast<const char *> (header), sizeof (header));
+        device->write (frame);
+    }
+
+    explicit QQmlObjectListModelPublisher (QQmlObjectListModelBase * model, QObject * parent = Q_NULLPTR)
+        : QObject (parent)
+        , m_model (model)
+        , m_server (new QLocalServer (this))
+        , m_flushQueued (false)
+    {
+        m_buffer.open (QIODevice::WriteOnly);
+        m_stream.setDevice (&m_buffer);
+        m_stream.setVersion (streamVersion ());
+        connect (m_server, &QLocalServer::newConnection, this, &QQmlObjectListModelPublisher::onNewConnection);
+    }
+    bool listen (const QString & name) {
+        bool ret = m_server->listen (name);
+        if (!ret && m_server->serverError () == QAbstractSocket::AddressInUseError) {
+            QLocalSocket probe;
+            probe.connectToServer (name);
+            if (!probe.waitForConnected (100)) { // NOTE : nobody answers, a crashed publisher left its socket file behind
+                QLocalServer::removeServer (name);
+                ret = m_server->listen (name);
+            }
+        }
+        return ret;
+    }
+    int clientCount (void) const {
+        return m_clients.count ();
+    }
+
+public slots:
+    void flush (void) {
+        m_flushQueued = false;
+        if (m_buffer.size () > 0) {
+            const QByteArray frame = m_buffer.data ();
+            for (QList<QLocalSocket *>::const_iterator it = m_clients.constBegin (); it != m_clients.constEnd (); ++it) {
+                writeFrame (* it, frame);
+            }
+            m_buffer.buffer ().clear ();
+            m_buffer.seek (0);
+        }
+    }
+
+protected slots:
+    void onNewConnection (void) {
+        while (QLocalSocket * socket = m_server->nextPendingConnection ()) {
+            if (m_clients.isEmpty ()) { // NOTE : the models are only watched while someone is listening
+                watch (m_model, Q_NULLPTR, Q_NULLPTR, 0);
+            }
+            // NOTE : encoding the snapshot can decode lazily loaded rows, which the other clients must get as changes
+            const QByteArray block = m_model->snapshotRows (0, m_model->count ());
+            flush ();
+            QByteArray frame;
+            QDataStream stream (&frame, QIODevice::WriteOnly);
+            stream.setVersion (streamVersion ());
+            for (int id = 0; id < m_roleNames.count (); id++) {
+                stream << quint8 (DefineRole) << quint16 (id) << m_roleNames.at (id);
+            }
+            stream << quint8 (Snapshot) << block;
+            writeFrame (socket, frame);
+            m_clients.append (socket);
+            connect (socket, &QLocalSocket::disconnected, this, [this, socket] (void) {
+                m_clients.removeAll (socket);
+                socket->deleteLater ();
+                if (m_clients.isEmpty ()) {
+                    unwatch (m_model);
+                    m_buffer.buffer ().clear ();
+                    m_buffer.seek (0);
+                }
+            });
+        }
+    }
+
+protected:
+    struct Watch {
+        Watch (void) : parentModel (Q_NULLPTR), item (Q_NULLPTR), roleId (0), typed (false) { }
+        QQmlObjectListModelBase *        parentModel; // null for the root model
+        QObject *                        item;        // item holding the model in its parent
+        quint16                          roleId;      // role holding the model in that item
+        bool                             typed;       // whether the roles below are known yet
+        QVector<int>                     valueRoles;  // writable roles, sent on change
+        QVector<quint16>                 valueIds;
+        QVector<QPair<QByteArray, quint16> > nestedRoles; // roles holding a nested model
+    };
+
+    void watch (QQmlObjectListModelBase * model, QQmlObjectListModelBase * parentModel, QObject * item, quint16 roleId) {
+        if (model != Q_NULLPTR && !m_watches.contains (model)) {
+            Watch & entry = m_watches [model];
+            entry.parentModel = parentModel;
+            entry.item        = item;
+            entry.roleId      = roleId;
+            connect (model, &QObject::destroyed, this, [this] (QObject * obj) {
+                m_watches.remove (obj);
+            });
+            connect (model, &QAbstractItemModel::rowsInserted, this, [this, model] (const QModelIndex &, int first, int last) {
+                if (beginRecord (model, Insert)) {
+                    m_stream << quint32 (first) << model->snapshotRows (first, last - first +1);
+                }
+                watchRows (model, first, last);
+            });
+            connect (model, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this, model] (const QModelIndex &, int first, int last) {
+                unwatchRows (model, first, last);
+            });
+            connect (model, &QAbstractItemModel::rowsRemoved, this, [this, model] (const QModelIndex &, int first, int last) {
+                if (beginRecord (model, Remove)) {
+                    m_stream << quint32 (first) << quint32 (last - first +1);
+                }
+            });
+            connect (model, &QAbstractItemModel::rowsMoved, this, [this, model] (const QModelIndex &, int first, int last, const QModelIndex &, int dest) {
+                const int count = (last - first +1);
+                if (beginRecord (model, Move)) { // NOTE : 'dest' is the row before which the range goes, as known before the move
+                    m_stream << quint32 (first) << quint32 (count) << quint32 (dest > last ? dest - count : dest);
+                }
+            });
+            connect (model, &QAbstractItemModel::modelAboutToBeReset, this, [this, model] (void) {
+                unwatchRows (model, 0, model->count () -1);
+            });
+            connect (model, &QAbstractItemModel::modelReset, this, [this, model] (void) {
+                if (beginRecord (model, Reset)) {
+                    m_stream << model->snapshotRows (0, model->count ());
+                }
+                watchRows (model, 0, model->count () -1);
+            });
+            connect (model, &QAbstractItemModel::dataChanged, this, [this, model] (const QModelIndex & topLeft, const QModelIndex & bottomRight, const QVector<int> & roles) {
+                onDataChanged (model, topLeft.row (), bottomRight.row (), roles);
+            });
+            watchRows (model, 0, model->count () -1);
+        }
+    }
+    void unwatch (QQmlObjectListModelBase * model) {
+        if (model != Q_NULLPTR && m_watches.contains (model)) {
+            disconnect (model, Q_NULLPTR, this, Q_NULLPTR);
+            unwatchRows (model, 0, model->count () -1);
+            m_watches.remove (model);
+        }
+    }
+    void watchRows (QQmlObjectListModelBase * model, int first, int last) {
+        for (int row = first; row <= last; row++) {
+            if (QObject * item = model->get (row)) {
+                const QVector<QPair<QByteArray, quint16> > nestedRoles = rolesOf (model, item).nestedRoles; // NOTE : copied, watching grows the hash
+                for (QVector<QPair<QByteArray, quint16> >::const_iterator it = nestedRoles.constBegin (); it != nestedRoles.constEnd (); ++it) {
+                    watch (nestedModel (item, it->first), model, item, it->second);
+                }
+            }
+        }
+    }
+    void unwatchRows (QQmlObjectListModelBase * model, int first, int last) {
+        const QHash<QObject *, Watch>::const_iterator watchIt = m_watches.constFind (model);
+        if (watchIt != m_watches.constEnd () && watchIt->typed) {
+            const QVector<QPair<QByteArray, quint16> > nestedRoles = watchIt->nestedRoles;
+            for (int row = first; row <= last; row++) {
+                if (QObject * item = model->get (row)) {
+                    for (QVector<QPair<QByteArray, quint16> >::const_iterator it = nestedRoles.constBegin (); it != nestedRoles.constEnd (); ++it) {
+                        unwatch (nestedModel (item, it->first));
+                    }
+                }
+            }
+        }
+    }
+    const Watch & rolesOf (QQmlObjectListModelBase * model, QObject * item) { // sorts the roles of a model, using one of its items
+        Watch & entry = m_watches [model];
+        if (!entry.typed) {
+            entry.typed = true;
+            const QHash<int, QByteArray> roles = model->roleNames ();
+            const QMetaObject * metaObj = item->metaObject ();
+            for (QHash<int, QByteArray>::const_iterator it = roles.constBegin (); it != roles.constEnd (); ++it) {
+                const int propIdx = (it.key () > Qt::UserRole ? metaObj->indexOfProperty (it.value ().constData ()) : -1);
+                if (propIdx >= 0) {
+                    const QMetaProperty metaProp = metaObj->property (propIdx);
+                    if (QMetaType::typeFlags (metaProp.userType ()) & QMetaType::PointerToQObject) {
+                        entry.nestedRoles.append (qMakePair (it.value (), roleId (it.value ())));
+                    }
+                    else if (metaProp.isWritable ()) {
+                        entry.valueRoles.append (it.key ());
+                        entry.valueIds.append (roleId (it.value ()));
+                    }
+                }
+            }
+        }
+        return entry;
+    }
+    static QQmlObjectListModelBase * nestedModel (QObject * item, const QByteArray & name) {
+        return qobject_cast<QQmlObjectListModelBase *> (item->property (name.constData ()).value<QObject *> ());
+    }
+    quint16 roleId (const QByteArray & name) { // NOTE : never called while a record is being written
+        QHash<QByteArray, quint16>::const_iterator it = m_roleIds.constFind (name);
+        if (it != m_roleIds.constEnd ()) {
+            return it.value ();
+        }
+        const quint16 ret = quint16 (m_roleNames.count ());
+        m_roleIds.insert (name, ret);
+        m_roleNames.append (name);
+        if (!m_clients.isEmpty ()) {
+            m_stream << quint8 (DefineRole) << ret << name;
+        }
+        return ret;
+    }
+    bool pathOf (QObject * model, QVector<QPair<quint32, quint16> > & path) const {
+        const QHash<QObject *, Watch>::const_iterator it = m_watches.constFind (model);
+        if (it == m_watches.constEnd ()) {
+            return false;
+        }
+        if (it->parentModel != Q_NULLPTR) {
+            const int row = it->parentModel->viewIndexOf (it->item); // NOTE : -1 when the clients don't know the item yet
+            if (row < 0 || !pathOf (it->parentModel, path)) {
+                return false;
+            }
+            path.append (qMakePair (quint32 (row), it->roleId));
+        }
+        return true;
+    }
+    bool beginRecord (QObject * model, RecordType type) {
+        QVector<QPair<quint32, quint16> > path;
+        const bool ret = (!m_clients.isEmpty () && pathOf (model, path));
+        if (ret) {
+            m_stream << quint8 (type) << quint8 (path.count ());
+            for (QVector<QPair<quint32, quint16> >::const_iterator it = path.constBegin (); it != path.constEnd (); ++it) {
+                m_stream << it->first << it->second;
+            }
+            scheduleFlush ();
+        }
+        return ret;
+    }
+    void onDataChanged (QQmlObjectListModelBase * model, int first, int last, const QVector<int> & roles) {
+        QObject * item = model->get (first);
+        if (!m_clients.isEmpty () && item != Q_NULLPTR) {
+            const Watch & entry = rolesOf (model, item);
+            QVector<int> changed; // positions in the value roles
+            for (int idx = 0; idx < entry.valueRoles.count (); idx++) {
+                if (roles.isEmpty () || roles.contains (entry.valueRoles.at (idx))) {
+                    changed.append (idx);
+                }
+            }
+            if (!changed.isEmpty ()) {
+                for (int row = first; row <= last; row++) {
+                    if (beginRecord (model, SetData)) {
+                        const QModelIndex index = model->index (row, 0);
+                        m_stream << quint32 (row) << quint16 (changed.count ());
+                        for (QVector<int>::const_iterator it = changed.constBegin (); it != changed.constEnd (); ++it) {
+                            m_stream << entry.valueIds.at (* it) << model->data (index, entry.valueRoles.at (* it));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    void scheduleFlush (void) {
+        if (!m_flushQueued) {
+            m_flushQueued = true;
+            QMetaObject::invokeMethod (this, "flush", Qt::QueuedConnection);
+        }
+    }
+
+private:
+    QQmlObjectListModelBase *  m_model;
+    QLocalServer *             m_server;
+    QList<QLocalSocket *>      m_clients;
+    bool                       m_flushQueued;
+    QBuffer                    m_buffer;
+    QDataStream                m_stream;
+    QHash<QObject *, Watch>    m_watches;
+    QHash<QByteArray, quint16> m_roleIds;
+    QList<QByteArray>          m_roleNames;
+};
+
+class QQmlObjectListModelReplica : public QObject {
+    Q_OBJECT
+
+public:
+    explicit QQmlObjectListModelReplica (QQmlObjectListModelBase * model, QObject * parent = Q_NULLPTR)
+        : QObject (parent)
+        , m_model (model)
+        , m_socket (new QLocalSocket (this))
+    {
+        connect (m_socket, &QLocalSocket::readyRead, this, &QQmlObjectListModelReplica::onReadyRead);
+    }
+    void connectToPublisher (const QString & name) {
+        m_socket->abort ();
+        m_buffer.clear ();
+        m_roleNames.clear ();
+        m_socket->connectToServer (name, QIODevice::ReadOnly);
+    }
+    bool isConnected (void) const {
+        return (m_socket->state () == QLocalSocket::ConnectedState);
+    }
+
+protected slots:
+    void onReadyRead (void) {
+        m_buffer.append (m_socket->readAll ());
+        int offset = 0;
+        while (m_buffer.size () - offset >= 4) {
+            const quint32 size = qFromBigEndian<quint32> (reinterpret_cast<const uchar *> (m_buffer.constData () + offset));
+            if (quint32 (m_buffer.size () - offset - 4) < size) {
+                break;
+            }
+            if (!applyFrame (QByteArray::fromRawData (m_buffer.constData () + offset + 4, int (size)))) {
+                qWarning () << "Invalid replication frame, disconnecting";
+                m_socket->abort ();
+                m_buffer.clear ();
+                return;
+            }
+            offset += (4 + int (size));
+        }
+        m_buffer.remove (0, offset);
+    }
+
+protected:
+    bool applyFrame (const QByteArray & frame) {
+        QDataStream stream (frame);
+        stream.setVersion (QQmlObjectListModelPublisher::streamVersion ());
+        QList<QPointer<QQmlObjectListModelBase> > batched; // one batch per touched model, for the whole frame
+        while (!stream.atEnd () && stream.status () == QDataStream::Ok) {
+            quint8 type = 0;
+            stream >> type;
+            if (type == QQmlObjectListModelPublisher::DefineRole) {
+                quint16 id = 0;
+                QByteArray name;
+                stream >> id >> name;
+                while (m_roleNames.count () <= id) {
+                    m_roleNames.append (QByteArray ());
+                }
+                m_roleNames [id] = name;
+            }
+            else if (type == QQmlObjectListModelPublisher::Snapshot) {
+                QByteArray block;
+                stream >> block;
+                if (!m_model->readSnapshot (block, false)) {
+                    stream.setStatus (QDataStream::ReadCorruptData); // NOTE : an unreadable block drops the connection too
+                }
+            }
+            else {
+                QQmlObjectListModelBase * model = resolve (stream);
+                if (model != Q_NULLPTR && !batched.contains (model)) {
+                    model->beginBatch ();
+                    batched.append (model);
+                }
+                switch (type) {
+                    case QQmlObjectListModelPublisher::Insert: {
+                        quint32 row = 0;
+                        QByteArray block;
+                        stream >> row >> block;
+                        if (model != Q_NULLPTR && !model->readRows (block, int (row))) {
+                            stream.setStatus (QDataStream::ReadCorruptData);
+                        }
+                        break;
+                    }
+                    case QQmlObjectListModelPublisher::Remove: {
+                        quint32 row = 0, count = 0;
+                        stream >> row >> count;
+                        if (model != Q_NULLPTR) {
+                            model->removeRange (int (row), int (count));
+                        }
+                        break;
+                    }
+                    case QQmlObjectListModelPublisher::Move: {
+                        quint32 row = 0, count = 0, pos = 0;
+                        stream >> row >> count >> pos;
+                        if (model != Q_NULLPTR) {
+                            model->moveRange (int (row), int (count), int (pos));
+                        }
+                        break;
+                    }
+                    case QQmlObjectListModelPublisher::SetData: {
+                        quint32 row = 0;
+                        quint16 count = 0;
+                        stream >> row >> count;
+                        for (quint16 idx = 0; idx < count && stream.status () == QDataStream::Ok; idx++) {
+                            quint16 id = 0;
+                            QVariant value;
+                            stream >> id >> value;
+                            if (model != Q_NULLPTR) {
+                                model->setRoleValue (int (row), model->roleForName (m_roleNames.value (id)), value);
+                            }
+                        }
+                        break;
+                    }
+                    case QQmlObjectListModelPublisher::Reset: {
+                        QByteArray block;
+                        stream >> block;
+                        if (model != Q_NULLPTR && !model->readSnapshot (block, false)) {
+                            stream.setStatus (QDataStream::ReadCorruptData);
+                        }
+                        break;
+                    }
+                    default: {
+                        stream.setStatus (QDataStream::ReadCorruptData);
+                        break;
+                    }
+                }
+            }
+        }
+        for (int idx = batched.count () -1; idx >= 0; idx--) {
+            if (QQmlObjectListModelBase * model = batched.at (idx)) {
+                model->endBatch ();
+            }
+        }
+        return (stream.status () == QDataStream::Ok);
+    }
+    QQmlObjectListModelBase * resolve (QDataStream & stream) const { // follows the path of a nested model
+        QQmlObjectListModelBase * ret = m_model;
+        quint8 depth = 0;
+        stream >> depth;
+        for (quint8 level = 0; level < depth; level++) {
+            quint32 row = 0;
+            quint16 id = 0;
+            stream >> row >> id;
+            QObject * item = (ret != Q_NULLPTR ? ret->get (int (row)) : Q_NULLPTR);
+            ret = (item != Q_NULLPTR ? qobject_cast<QQmlObjectListModelBase *> (item->property (m_roleNames.value (id).constData ()).value<QObject *> ()) : Q_NULLPTR);
+        }
+        return ret;
+    }
+
+private:
+    QQmlObjectListModelBase * m_model;
+    QLocalSocket *            m_socket;
+    QByteArray                m_buffer;
+    QList<QByteArray>         m_roleNames;
+};
+
+#endif // QQMLOBJECTLISTMODELREPLICATION_H
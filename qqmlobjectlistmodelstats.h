@@ -0,0 +1,227 @@
+#ifndef QQMLOBJECTLISTMODELSTATS_H
+#define QQMLOBJECTLISTMODELSTATS_H
+
+/*!
+    \class QQmlObjectListModelStats
+
+    \ingroup QT_QML_MODELS
+
+    \brief Runtime counters of a QQmlObjectListModel, for logs and QML overlays
+
+    The instrumentation only exists when \c QQMLOBJECTLISTMODEL_STATS is defined (e.g. with
+    \c {DEFINES += QQMLOBJECTLISTMODEL_STATS} in the project file). Otherwise this class, the
+    \c stats property of the models and all the hooks are compiled out, with no cost at all.
+
+    It counts the \c data() calls per role, the \c setData() calls, the signals emitted by the
+    model per type, the inserted and removed rows, the time spent handling item property changes
+    and referencing items, and the peak row count.
+
+    The properties notify their changes at most 4 times per second, so that a QML overlay
+    binding on them doesn't cost more than what it measures.
+
+    Example in use :
+    \code
+        Text {
+            text: "data() calls : " + JSON.stringify (testModel.stats.dataCallsByRole);
+        }
+    \endcode
+
+    \sa QQmlObjectListModelBase::dumpStats()
+*/
+
+
+#ifdef QQMLOBJECTLISTMODEL_STATS
+
+#include <QAbstractItemModel>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringBuilder>
+#include <QTimer>
+#include <QVariantMap>
+
+#define QQML_OBJMODEL_STAT(...) __VA_ARGS__
+
+class QQmlObjectListModelStats : public QObject {
+    Q_OBJECT
+    Q_PROPERTY (QVariantMap dataCallsByRole   READ dataCallsByRole   NOTIFY updated)
+    Q_PROPERTY (qint64      setDataCalls      READ setDataCalls      NOTIFY updated)
+    Q_PROPERTY (QVariantMap signalsByType     READ signalsByType     NOTIFY updated)
+    Q_PROPERTY (qint64      rowsInserted      READ rowsInserted      NOTIFY updated)
+    Q_PROPERTY (qint64      rowsRemoved       READ rowsRemoved       NOTIFY updated)
+    Q_PROPERTY (qint64      propertyChangedNs READ propertyChangedNs NOTIFY updated)
+    Q_PROPERTY (qint64      referenceItemNs   READ referenceItemNs   NOTIFY updated)
+    Q_PROPERTY (int         peakRowCount      READ peakRowCount      NOTIFY updated)
+
+public:
+    enum Timing {
+        PropertyChanged,
+        ReferenceItem,
+    };
+
+    class ScopedTimer { // adds the time spent in its scope to a timing
+    public:
+        explicit ScopedTimer (QQmlObjectListModelStats * stats, Timing timing) : m_stats (stats), m_timing (timing) {
+            m_timer.start ();
+        }
+        ~ScopedTimer (void) {
+            m_stats->addTime (m_timing, m_timer.nsecsElapsed ());
+        }
+
+    private:
+        Q_DISABLE_COPY (ScopedTimer)
+        QQmlObjectListModelStats * m_stats;
+        Timing                     m_timing;
+        QElapsedTimer              m_timer;
+    };
+
+    explicit QQmlObjectListModelStats (QAbstractItemModel * model)
+        : QObject (model)
+        , m_model (model)
+        , m_updateQueued (false)
+        , m_setDataCalls (0)
+        , m_rowsInserted (0)
+        , m_rowsRemoved (0)
+        , m_propertyChangedNs (0)
+        , m_referenceItemNs (0)
+        , m_peakRowCount (0)
+    { // NOTE : built by the model constructor, so it must not call the model virtuals here
+        connect (model, &QAbstractItemModel::dataChanged, this, [this] (void) {
+            countSignal (QStringLiteral ("dataChanged"));
+        });
+        connect (model, &QAbstractItemModel::rowsInserted, this, [this] (const QModelIndex &, int first, int last) {
+            countSignal (QStringLiteral ("rowsInserted"));
+            m_rowsInserted += (last - first +1);
+            m_peakRowCount = qMax (m_peakRowCount, m_model->rowCount ());
+        });
+        connect (model, &QAbstractItemModel::rowsRemoved, this, [this] (const QModelIndex &, int first, int last) {
+            countSignal (QStringLiteral ("rowsRemoved"));
+            m_rowsRemoved += (last - first +1);
+        });
+        connect (model, &QAbstractItemModel::rowsMoved, this, [this] (void) {
+            countSignal (QStringLiteral ("rowsMoved"));
+        });
+        connect (model, &QAbstractItemModel::modelReset, this, [this] (void) {
+            countSignal (QStringLiteral ("modelReset"));
+            m_peakRowCount = qMax (m_peakRowCount, m_model->rowCount ());
+        });
+        connect (model, &QAbstractItemModel::layoutChanged, this, [this] (void) {
+            countSignal (QStringLiteral ("layoutChanged"));
+        });
+    }
+    void countData (int role) {
+        m_dataCalls [role]++;
+        touch ();
+    }
+    void countSetData (void) {
+        m_setDataCalls++;
+        touch ();
+    }
+    void countSignal (const QString & type) {
+        m_signals [type]++;
+        touch ();
+    }
+    void addTime (Timing timing, qint64 nsecs) {
+        (timing == PropertyChanged ? m_propertyChangedNs : m_referenceItemNs) += nsecs;
+        touch ();
+    }
+    QVariantMap dataCallsByRole (void) const {
+        QVariantMap ret;
+        const QHash<int, QByteArray> roles = m_model->roleNames ();
+        for (QHash<int, qint64>::const_iterator it = m_dataCalls.constBegin (); it != m_dataCalls.constEnd (); ++it) {
+            ret.insert (QString::fromUtf8 (roles.value (it.key (), QByteArray::number (it.key ()))), it.value ());
+        }
+        return ret;
+    }
+    qint64 setDataCalls (void) const {
+        return m_setDataCalls;
+    }
+    QVariantMap signalsByType (void) const {
+        QVariantMap ret;
+        for (QHash<QString, qint64>::const_iterator it = m_signals.constBegin (); it != m_signals.constEnd (); ++it) {
+            ret.insert (it.key (), it.value ());
+        }
+        return ret;
+    }
+    qint64 rowsInserted (void) const {
+        return m_rowsInserted;
+    }
+    qint64 rowsRemoved (void) const {
+        return m_rowsRemoved;
+    }
+    qint64 propertyChangedNs (void) const {
+        return m_propertyChangedNs;
+    }
+    qint64 referenceItemNs (void) const {
+        return m_referenceItemNs;
+    }
+    int peakRowCount (void) const {
+        return m_peakRowCount;
+    }
+
+public slots:
+    void reset (void) {
+        m_dataCalls.clear ();
+        m_signals.clear ();
+        m_setDataCalls      = 0;
+        m_rowsInserted      = 0;
+        m_rowsRemoved       = 0;
+        m_propertyChangedNs = 0;
+        m_referenceItemNs   = 0;
+        m_peakRowCount      = m_model->rowCount ();
+        touch ();
+    }
+    QString dump (void) const {
+        QString ret = (QStringLiteral ("%1 (%2)").arg (QString::fromLatin1 (m_model->metaObject ()->className ()), m_model->objectName ()));
+        const QVariantMap dataCalls = dataCallsByRole ();
+        for (QVariantMap::const_iterator it = dataCalls.constBegin (); it != dataCalls.constEnd (); ++it) {
+            ret += (QStringLiteral ("\n  data(") % it.key () % QStringLiteral (") : ") % it.value ().toString ());
+        }
+        for (QHash<QString, qint64>::const_iterator it = m_signals.constBegin (); it != m_signals.constEnd (); ++it) {
+            ret += (QStringLiteral ("\n  ") % it.key () % QStringLiteral (" emitted : ") % QString::number (it.value ()));
+        }
+        ret += (QStringLiteral ("\n  setData() : ")         % QString::number (m_setDataCalls)
+                % QStringLiteral ("\n  rows inserted : ")   % QString::number (m_rowsInserted)
+                % QStringLiteral ("\n  rows removed : ")    % QString::number (m_rowsRemoved)
+                % QStringLiteral ("\n  property changes : ") % QString::number (m_propertyChangedNs / 1000) % QStringLiteral (" us")
+                % QStringLiteral ("\n  item references : ") % QString::number (m_referenceItemNs / 1000) % QStringLiteral (" us")
+                % QStringLiteral ("\n  peak row count : ")  % QString::number (m_peakRowCount));
+        return ret;
+    }
+
+signals:
+    void updated (void);
+
+protected:
+    void touch (void) {
+        if (!m_updateQueued) {
+            m_updateQueued = true;
+            QTimer::singleShot (250, this, [this] (void) {
+                m_updateQueued = false;
+                emit updated ();
+            });
+        }
+    }
+
+private:
+    QAbstractItemModel *   m_model;
+    bool                   m_updateQueued;
+    QHash<int, qint64>     m_dataCalls;
+    QHash<QString, qint64> m_signals;
+    qint64                 m_setDataCalls;
+    qint64                 m_rowsInserted;
+    qint64                 m_rowsRemoved;
+    qint64                 m_propertyChangedNs;
+    qint64                 m_referenceItemNs;
+    int                    m_peakRowCount;
+};
+
+#else
+
+#define QQML_OBJMODEL_STAT(...)
+
+#endif // QQMLOBJECTLISTMODEL_STATS
+
+#endif // QQMLOBJECTLISTMODELSTATS_H
@@ -0,0 +1,556 @@
+#ifndef QQMLOBJECTTREEMODEL_H
+#define QQMLOBJECTTREEMODEL_H
+
+/*!
+    \class QQmlObjectTreeModel
+
+    \ingroup QT_QML_MODELS
+
+    \brief Provides a single two-level model of QObject derived items (pages and their children), suitable for QML
+
+    Instead of one \c QQmlObjectListModel of children held by each page, which makes one more
+    \c QAbstractListModel with its own role hash and connections per page, QQmlObjectTreeModel
+    stores the pages as top-level rows and their children as child rows of one \c QAbstractItemModel.
+
+    The roles come from the role tables QQmlObjectListModel builds once per item class, merged by
+    name : a role name existing in both classes has a single role, resolved on the class of the row.
+    The roles holding a nested item model (such as a page's own submodel) are left out, so showing
+    the tree never reads them, nor builds them when they are created on demand.
+    The \c qtObject role gives the item itself. The items using \c QML_OBSERVABLE notify their
+    changes without any connection, each page keeps the rows of its children in a lazy index, and
+    the removed items are released all at once on next event-loop iteration.
+
+    Each page's list binds to its children with a \c DelegateModel :
+    \code
+        ListView {
+            model: DelegateModel {
+                model: treeModel;
+                rootIndex: treeModel.pageIndex (index);
+                delegate: Text { text: model.subname; }
+            }
+        }
+    \endcode
+
+    \b Note : The items without parent are owned by the model, and deleted when removed from it.
+    The same item can't be a page and a child at the same time.
+
+    \sa QQmlObjectListModel
+*/
+
+/*!
+    \fn QModelIndex QQmlObjectTreeModel::pageIndex (int row) const
+
+    \details Returns the model index of a page, to be used as the root of a view on its children.
+
+    \param row The position of the page
+    \return The model index of the page, invalid if the position is out of range
+*/
+
+
+#include <QAbstractItemModel>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMetaMethod>
+#include <QMetaObject>
+#include <QMetaProperty>
+#include <QMetaType>
+#include <QObject>
+#include <QSet>
+#include <QVariant>
+#include <QVector>
+
+#include <climits>
+
+#include "qqmlhelpers.h"
+#include "qqmlobjectlistmodel.h"
+
+class QQmlObjectTreeModelBase : public QAbstractItemModel { // abstract Qt base class
+    Q_OBJECT
+    Q_PROPERTY (int count READ count NOTIFY countChanged)
+
+public:
+    explicit QQmlObjectTreeModelBase (QObject * parent = Q_NULLPTR) : QAbstractItemModel (parent) { }
+
+public slots: // virtual methods API for QML
+    virtual int count (void) const = 0;
+    virtual int childCount (int row) const = 0;
+    virtual QModelIndex pageIndex (int row) const = 0;
+    virtual QObject * get (int row) const = 0;
+    virtual QObject * getChild (int row, int childRow) const = 0;
+    virtual void clear (void) = 0;
+    virtual void removePage (int row) = 0;
+    virtual void removeChild (int row, int childRow) = 0;
+
+protected slots: // internal callback
+    virtual void onItemPropertyChanged (void) = 0;
+    virtual void releaseItems (void) = 0;
+
+signals: // notifier
+    void countChanged (void);
+};
+
+template<class ParentType, class ChildType> class QQmlObjectTreeModel : public QQmlObjectTreeModelBase, protected QQmlItemObserver {
+    struct RoleMap; // merged roles of both item classes, see roleMap ()
+    struct Node; // a page and its children
+
+public:
+    using QObject::parent;
+
+    explicit QQmlObjectTreeModel (QObject * parent = Q_NULLPTR)
+        : QQmlObjectTreeModelBase (parent)
+        , m_meta (roleMap ())
+        , m_pagesDirtyFrom (INT_MAX)
+        , m_releaseQueued (false)
+    { }
+    ~QQmlObjectTreeModel (void) {
+        for (typename QList<Node *>::const_iterator it = m_pages.constBegin (); it != m_pages.constEnd (); ++it) {
+            qQmlDetachObserver ((* it)->item, this); // NOTE : the items not owned by the model outlive it
+            for (typename QList<ChildType *>::const_iterator child = (* it)->children.constBegin (); child != (* it)->children.constEnd (); ++child) {
+                qQmlDetachObserver (* child, this);
+            }
+        }
+        qDeleteAll (m_pages); // NOTE : the owned items are deleted as children of the model
+    }
+    QModelIndex index (int row, int column, const QModelIndex & parent = QModelIndex ()) const Q_DECL_FINAL {
+        QModelIndex ret;
+        if (column == 0 && row >= 0) {
+            if (!parent.isValid ()) {
+                if (row < m_pages.count ()) {
+                    ret = createIndex (row, 0);
+                }
+            }
+            else if (parent.internalPointer () == Q_NULLPTR && parent.row () < m_pages.count ()) {
+                Node * node = m_pages.at (parent.row ());
+                if (row < node->children.count ()) {
+                    ret = createIndex (row, 0, node); // NOTE : children point to their page node
+                }
+            }
+        }
+        return ret;
+    }
+    QModelIndex parent (const QModelIndex & child) const Q_DECL_FINAL {
+        const Node * node = static_cast<const Node *> (child.internalPointer ());
+        return (child.isValid () && node != Q_NULLPTR ? createIndex (pageRow (node), 0) : QModelIndex ());
+    }
+    int rowCount (const QModelIndex & parent = QModelIndex ()) const Q_DECL_FINAL {
+        int ret = 0;
+        if (!parent.isValid ()) {
+            ret = m_pages.count ();
+        }
+        else if (parent.internalPointer () == Q_NULLPTR && parent.row () < m_pages.count ()) {
+            ret = m_pages.at (parent.row ())->children.count ();
+        }
+        return ret;
+    }
+    int columnCount (const QModelIndex & parent = QModelIndex ()) const Q_DECL_FINAL {
+        Q_UNUSED (parent)
+        return 1;
+    }
+    QVariant data (const QModelIndex & index, int role) const Q_DECL_FINAL {
+        QVariant ret;
+        if (index.isValid ()) {
+            if (role == baseRole ()) {
+                ret = QVariant::fromValue (itemAt (index));
+            }
+            else if (index.internalPointer () == Q_NULLPTR) {
+                ParentType * item = page (index.row ());
+                const int idx = pageRoleIndex (role);
+                if (item != Q_NULLPTR && idx > 0) {
+                    ret = readProperty (m_meta->pageTable, idx, item);
+                }
+            }
+            else {
+                ChildType * item = childAt (index);
+                const int idx = childRoleIndex (role);
+                if (item != Q_NULLPTR && idx > 0) {
+                    ret = readProperty (m_meta->childTable, idx, item);
+                }
+            }
+        }
+        return ret;
+    }
+    bool setData (const QModelIndex & index, const QVariant & value, int role) Q_DECL_FINAL { // NOTE : notified back by the item
+        bool ret = false;
+        if (index.isValid () && role != baseRole ()) {
+            if (index.internalPointer () == Q_NULLPTR) {
+                ParentType * item = page (index.row ());
+                const int idx = pageRoleIndex (role);
+                if (item != Q_NULLPTR && idx > 0) {
+                    ret = writeProperty (m_meta->pageTable, idx, item, value);
+                }
+            }
+            else {
+                ChildType * item = childAt (index);
+                const int idx = childRoleIndex (role);
+                if (item != Q_NULLPTR && idx > 0) {
+                    ret = writeProperty (m_meta->childTable, idx, item, value);
+                }
+            }
+        }
+        return ret;
+    }
+    QHash<int, QByteArray> roleNames (void) const Q_DECL_FINAL {
+        return m_meta->roles;
+    }
+
+public: // C++ API
+    ParentType * page (int row) const {
+        return (row >= 0 && row < m_pages.count () ? m_pages.at (row)->item : Q_NULLPTR);
+    }
+    ChildType * child (int row, int childRow) const {
+        const Node * node = nodeAt (row);
+        return (node != Q_NULLPTR && childRow >= 0 && childRow < node->children.count () ? node->children.at (childRow) : Q_NULLPTR);
+    }
+    QList<ChildType *> childList (int row) const {
+        const Node * node = nodeAt (row);
+        return (node != Q_NULLPTR ? node->children : QList<ChildType *> ());
+    }
+    int indexOfPage (ParentType * item) const {
+        const Node * node = m_nodeByPage.value (item, Q_NULLPTR);
+        return (node != Q_NULLPTR ? pageRow (node) : -1);
+    }
+    int indexOfChild (ChildType * item) const {
+        const Node * node = m_nodeByChild.value (item, Q_NULLPTR);
+        return (node != Q_NULLPTR ? childRow (node, item) : -1);
+    }
+    void appendPage (ParentType * item) {
+        insertPage (m_pages.count (), item);
+    }
+    void insertPage (int row, ParentType * item) {
+        if (item != Q_NULLPTR && row >= 0 && row <= m_pages.count () && !m_nodeByPage.contains (item)) {
+            beginInsertRows (noParent (), row, row);
+            Node * node = new Node (item);
+            node->row = row;
+            m_pages.insert (row, node);
+            m_nodeByPage.insert (item, node);
+            invalidatePages (row); // NOTE : the pages after it moved down one row
+            referenceItem (item);
+            endInsertRows ();
+            emit countChanged ();
+        }
+    }
+    void appendChild (int row, ChildType * item) {
+        if (item != Q_NULLPTR) {
+            appendChildren (row, QList<ChildType *> () << item);
+        }
+    }
+    void appendChildren (int row, const QList<ChildType *> & itemList) {
+        Node * node = nodeAt (row);
+        if (node != Q_NULLPTR && !itemList.isEmpty ()) {
+            const int first = node->children.count ();
+            beginInsertRows (createIndex (row, 0), first, first + itemList.count () -1);
+            node->children.append (itemList);
+            for (int childRow = first; childRow < node->children.count (); childRow++) {
+                ChildType * item = node->children.at (childRow);
+                node->rowByChild.insert (item, childRow);
+                m_nodeByChild.insert (item, node);
+                referenceItem (item);
+            }
+            endInsertRows ();
+        }
+    }
+    void insertChild (int row, int childRow, ChildType * item) {
+        Node * node = nodeAt (row);
+        if (node != Q_NULLPTR && item != Q_NULLPTR && childRow >= 0 && childRow <= node->children.count ()) {
+            beginInsertRows (createIndex (row, 0), childRow, childRow);
+            node->children.insert (childRow, item);
+            node->rowByChild.insert (item, childRow);
+            invalidateChildren (node, childRow);
+            m_nodeByChild.insert (item, node);
+            referenceItem (item);
+            endInsertRows ();
+        }
+    }
+    void clearChildren (int row) {
+        Node * node = nodeAt (row);
+        if (node != Q_NULLPTR && !node->children.isEmpty ()) {
+            beginRemoveRows (createIndex (row, 0), 0, node->children.count () -1);
+            releaseChildren (node);
+            endRemoveRows ();
+        }
+    }
+
+public: // QML slots implementation
+    int count (void) const Q_DECL_FINAL {
+        return m_pages.count ();
+    }
+    int childCount (int row) const Q_DECL_FINAL {
+        const Node * node = nodeAt (row);
+        return (node != Q_NULLPTR ? node->children.count () : 0);
+    }
+    QModelIndex pageIndex (int row) const Q_DECL_FINAL {
+        return index (row, 0, noParent ());
+    }
+    QObject * get (int row) const Q_DECL_FINAL {
+        return static_cast<QObject *> (page (row));
+    }
+    QObject * getChild (int row, int childRow) const Q_DECL_FINAL {
+        return static_cast<QObject *> (child (row, childRow));
+    }
+    void clear (void) Q_DECL_FINAL {
+        if (!m_pages.isEmpty ()) {
+            beginResetModel ();
+            for (typename QList<Node *>::const_iterator it = m_pages.constBegin (); it != m_pages.constEnd (); ++it) {
+                releaseChildren (* it);
+                dereferenceItem ((* it)->item);
+            }
+            qDeleteAll (m_pages);
+            m_pages.clear ();
+            m_nodeByPage.clear ();
+            m_pagesDirtyFrom = INT_MAX;
+            endResetModel ();
+            emit countChanged ();
+        }
+    }
+    void removePage (int row) Q_DECL_FINAL {
+        Node * node = nodeAt (row);
+        if (node != Q_NULLPTR) {
+            beginRemoveRows (noParent (), row, row);
+            releaseChildren (node);
+            dereferenceItem (node->item);
+            m_nodeByPage.remove (node->item);
+            m_pages.removeAt (row);
+            delete node;
+            invalidatePages (row);
+            endRemoveRows ();
+            emit countChanged ();
+        }
+    }
+    void removeChild (int row, int childRow) Q_DECL_FINAL {
+        Node * node = nodeAt (row);
+        if (node != Q_NULLPTR && childRow >= 0 && childRow < node->children.count ()) {
+            beginRemoveRows (createIndex (row, 0), childRow, childRow);
+            ChildType * item = node->children.takeAt (childRow);
+            node->rowByChild.remove (item);
+            invalidateChildren (node, childRow);
+            m_nodeByChild.remove (item);
+            dereferenceItem (item);
+            endRemoveRows ();
+        }
+    }
+
+protected: // internal stuff
+    static const QModelIndex & noParent (void) {
+        static const QModelIndex ret = QModelIndex ();
+        return ret;
+    }
+    static const int & baseRole (void) {
+        static const int ret = Qt::UserRole;
+        return ret;
+    }
+    static const RoleMap * roleMap (void) {
+        static const RoleMap ret; // NOTE : built once per pair of item classes, on top of their shared role tables
+        return &ret;
+    }
+    Node * nodeAt (int row) const {
+        return (row >= 0 && row < m_pages.count () ? m_pages.at (row) : Q_NULLPTR);
+    }
+    QObject * itemAt (const QModelIndex & index) const {
+        QObject * ret = Q_NULLPTR;
+        if (index.isValid ()) {
+            if (index.internalPointer () == Q_NULLPTR) {
+                ret = page (index.row ());
+            }
+            else {
+                ret = childAt (index);
+            }
+        }
+        return ret;
+    }
+    ChildType * childAt (const QModelIndex & index) const {
+        const Node * node = static_cast<const Node *> (index.internalPointer ());
+        return (node != Q_NULLPTR && index.row () < node->children.count () ? node->children.at (index.row ()) : Q_NULLPTR);
+    }
+    inline int pageRoleIndex (int role) const { // index in the role table of the page class, or -1
+        const int idx = (role - baseRole ());
+        return (idx > 0 && idx < m_meta->pageIdxShown.count () && m_meta->pageIdxShown.at (idx) ? idx : -1);
+    }
+    inline int childRoleIndex (int role) const { // index in the role table of the child class, or -1
+        const int idx = (role - baseRole ());
+        return (idx > 0 && idx < m_meta->childIdxByIdx.count () ? m_meta->childIdxByIdx.at (idx) : -1);
+    }
+    template<class ItemType> static QVariant readProperty (const QQmlObjectRoleTable<ItemType> * table, int idx, ItemType * item) {
+        const QQmlFieldDescriptor * field = table->fieldByRole.at (idx); // NOTE : direct getter call for the properties made by the helper macros
+        return (field != Q_NULLPTR ? field->read (item) : table->propByRole.at (idx).read (item));
+    }
+    template<class ItemType> static bool writeProperty (const QQmlObjectRoleTable<ItemType> * table, int idx, ItemType * item, const QVariant & value) {
+        const QQmlFieldDescriptor * field = table->fieldByRole.at (idx);
+        return (field != Q_NULLPTR && field->write != Q_NULLPTR ? field->write (item, value) : table->propByRole.at (idx).write (item, value));
+    }
+    int pageRow (const Node * node) const {
+        if (node->row >= m_pagesDirtyFrom) {
+            for (int row = m_pagesDirtyFrom; row < m_pages.count (); row++) {
+                m_pages.at (row)->row = row;
+            }
+            m_pagesDirtyFrom = INT_MAX;
+        }
+        return node->row;
+    }
+    int childRow (const Node * node, ChildType * item) const {
+        typename QHash<ChildType *, int>::const_iterator it = node->rowByChild.constFind (item);
+        if (it == node->rowByChild.constEnd ()) {
+            return -1;
+        }
+        if (it.value () >= node->rowsDirtyFrom) {
+            for (int row = node->rowsDirtyFrom; row < node->children.count (); row++) {
+                node->rowByChild [node->children.at (row)] = row;
+            }
+            node->rowsDirtyFrom = INT_MAX;
+            it = node->rowByChild.constFind (item);
+        }
+        return it.value ();
+    }
+    inline void invalidatePages (int from) { // rows of the pages from 'from' are renumbered lazily
+        if (from < m_pages.count () && from < m_pagesDirtyFrom) {
+            m_pagesDirtyFrom = from;
+        }
+    }
+    static inline void invalidateChildren (const Node * node, int from) {
+        if (from < node->children.count () && from < node->rowsDirtyFrom) {
+            node->rowsDirtyFrom = from;
+        }
+    }
+    template<class ItemType> void referenceItem (ItemType * item) {
+        if (!item->parent ()) {
+            item->setParent (this);
+        }
+        m_graveyard.remove (item); // NOTE : removed and added back before being released
+        if (!qQmlAttachObserver (item, this)) { // NOTE : fallback for the items without QML_OBSERVABLE
+            const QHash<int, int> & signalIdxToRole = QQmlObjectRoleTable<ItemType>::get (QByteArray (), QByteArray ())->signalIdxToRole;
+            for (QHash<int, int>::const_iterator it = signalIdxToRole.constBegin (); it != signalIdxToRole.constEnd (); ++it) {
+                connect (item, item->metaObject ()->method (it.key ()), this, m_meta->handler, Qt::UniqueConnection);
+            }
+        }
+    }
+    template<class ItemType> void dereferenceItem (ItemType * item) {
+        if (!qQmlDetachObserver (item, this)) {
+            disconnect (item, Q_NULLPTR, this, Q_NULLPTR);
+        }
+        if (item->parent () == this) {
+            m_graveyard.insert (item);
+            if (!m_releaseQueued) {
+                m_releaseQueued = true;
+                QMetaObject::invokeMethod (this, "releaseItems", Qt::QueuedConnection);
+            }
+        }
+    }
+    void releaseChildren (Node * node) {
+        for (typename QList<ChildType *>::const_iterator it = node->children.constBegin (); it != node->children.constEnd (); ++it) {
+            m_nodeByChild.remove (* it);
+            dereferenceItem (* it);
+        }
+        node->children.clear ();
+        node->rowByChild.clear ();
+        node->rowsDirtyFrom = INT_MAX;
+    }
+    void releaseItems (void) Q_DECL_FINAL {
+        m_releaseQueued = false;
+        QSet<QObject *> graveyard;
+        graveyard.swap (m_graveyard);
+        for (typename QSet<QObject *>::const_iterator it = graveyard.constBegin (); it != graveyard.constEnd (); ++it) {
+            if ((* it)->parent () == this) {
+                delete (* it);
+            }
+        }
+    }
+    void onItemPropertyChanged (void) Q_DECL_FINAL {
+        handleItemPropertyChanged (sender (), senderSignalIndex ());
+    }
+    void itemPropertyChanged (QObject * item, int signalIdx, const QQmlOldValue & oldValue) Q_DECL_FINAL { // called by the QML_OBSERVABLE items
+        Q_UNUSED (oldValue)
+        handleItemPropertyChanged (item, signalIdx);
+    }
+    void handleItemPropertyChanged (QObject * item, int sig) {
+        QModelIndex index;
+        int role = -1;
+        if (const Node * node = m_nodeByPage.value (item, Q_NULLPTR)) {
+            const int pageRole = m_meta->pageTable->signalIdxToRole.value (sig, -1);
+            index = createIndex (pageRow (node), 0);
+            role  = (pageRoleIndex (pageRole) > 0 ? pageRole : -1);
+        }
+        else if (Node * node = m_nodeByChild.value (item, Q_NULLPTR)) {
+            index = createIndex (childRow (node, static_cast<ChildType *> (item)), 0, node);
+            const int childRole = m_meta->childTable->signalIdxToRole.value (sig, -1);
+            role  = (childRole > baseRole () ? m_meta->idxByChildIdx.value (childRole - baseRole (), -1) + baseRole () : -1);
+        }
+        if (index.isValid () && role > baseRole ()) {
+            emit dataChanged (index, index, QVector<int> () << role);
+        }
+    }
+
+private: // role metadata
+    struct RoleMap {
+        RoleMap (void)
+            : pageTable (QQmlObjectRoleTable<ParentType>::get (QByteArray (), QByteArray ()))
+            , childTable (QQmlObjectRoleTable<ChildType>::get (QByteArray (), QByteArray ()))
+        {
+            static const char * HANDLER = "onItemPropertyChanged()";
+            const QMetaObject & baseMetaObj = QQmlObjectTreeModelBase::staticMetaObject;
+            handler = baseMetaObj.method (baseMetaObj.indexOfMethod (HANDLER));
+            roles = pageTable->roles; // NOTE : the page roles keep their numbers, the child roles are merged by name
+            pageIdxShown.fill (false, pageTable->propByRole.count ());
+            for (int idx = 1; idx < pageTable->propByRole.count (); idx++) {
+                const QMetaProperty & metaProp = pageTable->propByRole.at (idx);
+                if (metaProp.isValid () && !isNestedModel (metaProp)) {
+                    pageIdxShown [idx] = true;
+                }
+                else {
+                    roles.remove (baseRole () + idx);
+                }
+            }
+            int next = pageTable->propByRole.count ();
+            idxByChildIdx.fill (-1, childTable->propByRole.count ());
+            for (int childIdx = 1; childIdx < childTable->propByRole.count (); childIdx++) {
+                const QMetaProperty & metaProp = childTable->propByRole.at (childIdx);
+                if (metaProp.isValid () && !isNestedModel (metaProp)) {
+                    const QByteArray name = childTable->roles.value (baseRole () + childIdx);
+                    int role = roles.key (name, -1);
+                    if (role < 0) {
+                        role = (baseRole () + next++);
+                        roles.insert (role, name);
+                    }
+                    idxByChildIdx [childIdx] = (role - baseRole ());
+                }
+            }
+            childIdxByIdx.fill (-1, next);
+            for (int childIdx = 1; childIdx < idxByChildIdx.count (); childIdx++) {
+                if (idxByChildIdx.at (childIdx) > 0) {
+                    childIdxByIdx [idxByChildIdx.at (childIdx)] = childIdx;
+                }
+            }
+        }
+        static bool isNestedModel (const QMetaProperty & metaProp) { // NOTE : left out, the tree replaces it and reading it may build it
+            const QMetaObject * metaObj = QMetaType::metaObjectForType (metaProp.userType ());
+            return (metaObj != Q_NULLPTR && metaObj->inherits (&QAbstractItemModel::staticMetaObject));
+        }
+        const QQmlObjectRoleTable<ParentType> * pageTable;
+        const QQmlObjectRoleTable<ChildType>  * childTable;
+        QMetaMethod                             handler;
+        QHash<int, QByteArray>                  roles;
+        QVector<bool>                           pageIdxShown; // index in the page table -> role kept in the tree
+        QVector<int>                            childIdxByIdx; // merged role index -> index in the child table
+        QVector<int>                            idxByChildIdx; // index in the child table -> merged role index
+    };
+
+private: // tree nodes
+    struct Node {
+        explicit Node (ParentType * i = Q_NULLPTR) : item (i), row (-1), rowsDirtyFrom (INT_MAX) { }
+        ParentType *                   item;
+        mutable int                    row;
+        QList<ChildType *>             children;
+        mutable QHash<ChildType *, int> rowByChild; // NOTE : lazily renumbered from rowsDirtyFrom
+        mutable int                    rowsDirtyFrom;
+    };
+
+private: // data members
+    const RoleMap *            m_meta;
+    QList<Node *>              m_pages;
+    mutable int                m_pagesDirtyFrom;
+    QHash<QObject *, Node *>   m_nodeByPage; // NOTE : keyed by QObject so that the sender can be looked up without cast
+    QHash<QObject *, Node *>   m_nodeByChild;
+    QSet<QObject *>            m_graveyard;
+    bool                       m_releaseQueued;
+};
+
+#endif // QQMLOBJECTTREEMODEL_H
@@ -0,0 +1,279 @@
+#ifndef QQMLSORTFILTEROBJECTLISTMODEL_H
+#define QQMLSORTFILTEROBJECTLISTMODEL_H
+
+/*!
+    \class QQmlSortFilterObjectListModel
+
+    \ingroup QT_QML_MODELS
+
+    \brief Provides a sorted and filtered view over a QQmlObjectListModel, suitable for QML
+
+    Unlike a \c QSortFilterProxyModel, the comparisons and the filtering don't go through
+    \c data() and \c QVariant : the sort key is read from the items by a typed accessor,
+    and cached for each accepted item.
+
+    The view is maintained incrementally from the signals of the source model : inserted
+    items are placed by binary search, removed items are found by binary search on their
+    cached key, and an item whose key changed is moved (with \c rowsMoved()) to the position
+    found by binary search. Only a reset of the source rebuilds the whole view.
+
+    Equal keys are ordered by item address, so that the position of an item is always
+    well defined and can be found back in O(log n).
+
+    Example in use :
+    \code
+        QQmlSortFilterObjectListModel<MySubmodel, QString> * sorted =
+            new QQmlSortFilterObjectListModel<MySubmodel, QString> (submodel, [] (const MySubmodel * item) {
+                return item->get_subname ();
+            });
+        sorted->setFilter ([] (const MySubmodel * item) { return item->get_subid () > 0; });
+    \endcode
+
+    \b Note : The view is owned by its source model unless another parent is given.
+*/
+
+/*!
+    \fn void QQmlSortFilterObjectListModel::setFilter (Filter filter)
+
+    \details Sets the predicate telling which items of the source are shown, and rebuilds the view.
+
+    \param filter A callable taking a \c {const ItemType*}, or an empty function to accept all items
+*/
+
+/*!
+    \fn void QQmlSortFilterObjectListModel::setSortOrder (Qt::SortOrder order)
+
+    \details Sets the sort order of the view, and rebuilds it.
+
+    \param order The new sort order
+*/
+
+/*!
+    \fn int QQmlSortFilterObjectListModel::mapToSource (int row) const
+
+    \details Returns the row in the source model of a row of the view.
+
+    \param row The row in the view
+    \return The row in the source model, \c -1 if not found
+*/
+
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QVector>
+
+#include <algorithm>
+#include <functional>
+
+#include "qqmlobjectlistmodel.h"
+
+class QQmlSortFilterObjectListModelBase : public QAbstractListModel { // abstract Qt base class
+    Q_OBJECT
+    Q_PROPERTY (int count READ count NOTIFY countChanged)
+
+public:
+    explicit QQmlSortFilterObjectListModelBase (QObject * parent = Q_NULLPTR) : QAbstractListModel (parent) { }
+
+public slots: // virtual methods API for QML
+    virtual int count (void) const = 0;
+    virtual QObject * get (int idx) const = 0;
+    virtual int mapToSource (int row) const = 0;
+    virtual void invalidate (void) = 0;
+
+signals: // notifier
+    void countChanged (void);
+};
+
+template<class ItemType, typename SortKey> class QQmlSortFilterObjectListModel : public QQmlSortFilterObjectListModelBase {
+public:
+    typedef std::function<SortKey (const ItemType *)> KeyAccessor;
+    typedef std::function<bool (const ItemType *)>    Filter;
+
+    explicit QQmlSortFilterObjectListModel (QQmlObjectListModel<ItemType> * source,
+                                            const KeyAccessor &             key,
+                                            Qt::SortOrder                   order  = Qt::AscendingOrder,
+                                            QObject *                       parent = Q_NULLPTR)
+        : QQmlSortFilterObjectListModelBase (parent != Q_NULLPTR ? parent : source)
+        , m_order (order)
+        , m_key (key)
+        , m_source (source)
+    {
+        typedef QQmlObjectListModel<ItemType> Source;
+        connect (m_source, &Source::rowsInserted, this, [this] (const QModelIndex &, int first, int last) {
+            for (int row = first; row <= last; row++) {
+                insertItem (m_source->at (row));
+            }
+        });
+        connect (m_source, &Source::rowsAboutToBeRemoved, this, [this] (const QModelIndex &, int first, int last) {
+            for (int row = first; row <= last; row++) {
+                removeItem (m_source->at (row));
+            }
+        });
+        connect (m_source, &Source::dataChanged, this, [this] (const QModelIndex & topLeft, const QModelIndex & bottomRight) {
+            for (int row = topLeft.row (); row <= bottomRight.row (); row++) {
+                updateItem (m_source->at (row));
+            }
+        });
+        connect (m_source, &Source::modelReset,    this, [this] (void) { invalidate (); });
+        connect (m_source, &Source::layoutChanged, this, [this] (void) { invalidate (); });
+        // NOTE : rowsMoved doesn't change the order of a sorted view
+        invalidate ();
+    }
+    QVariant data (const QModelIndex & index, int role) const Q_DECL_FINAL {
+        return m_source->roleValue (at (index.row ()), role);
+    }
+    bool setData (const QModelIndex & index, const QVariant & value, int role) Q_DECL_FINAL {
+        return m_source->setRoleValue (at (index.row ()), role, value);
+    }
+    QHash<int, QByteArray> roleNames (void) const Q_DECL_FINAL {
+        return m_source->roleNames ();
+    }
+    int rowCount (const QModelIndex & parent = QModelIndex ()) const Q_DECL_FINAL {
+        return (!parent.isValid () ? m_rows.count () : 0);
+    }
+
+public: // C++ API
+    ItemType * at (int row) const {
+        return (row >= 0 && row < m_rows.count () ? m_rows.at (row).item : Q_NULLPTR);
+    }
+    int indexOf (ItemType * item) const {
+        typename QHash<ItemType *, SortKey>::const_iterator it = m_keyByItem.constFind (item);
+        return (it != m_keyByItem.constEnd () ? lowerBound (Entry (it.value (), item)) : -1);
+    }
+    void setFilter (const Filter & filter) {
+        m_filter = filter;
+        invalidate ();
+    }
+    void setSortOrder (Qt::SortOrder order) {
+        if (m_order != order) {
+            m_order = order;
+            invalidate ();
+        }
+    }
+    Qt::SortOrder sortOrder (void) const {
+        return m_order;
+    }
+
+public: // QML slots implementation
+    int count (void) const Q_DECL_FINAL {
+        return m_rows.count ();
+    }
+    QObject * get (int idx) const Q_DECL_FINAL {
+        return static_cast<QObject *> (at (idx));
+    }
+    int mapToSource (int row) const Q_DECL_FINAL {
+        return m_source->indexOf (at (row));
+    }
+    void invalidate (void) Q_DECL_FINAL {
+        const int oldCount = m_rows.count ();
+        beginResetModel ();
+        m_rows.clear ();
+        m_keyByItem.clear ();
+        m_rows.reserve (m_source->count ());
+        for (typename QQmlObjectListModel<ItemType>::const_iterator it = m_source->constBegin (); it != m_source->constEnd (); ++it) {
+            ItemType * item = (* it);
+            if (accepts (item)) {
+                const Entry entry (m_key (item), item);
+                m_rows.append (entry);
+                m_keyByItem.insert (item, entry.key);
+            }
+        }
+        std::sort (m_rows.begin (), m_rows.end (), LessThan (m_order));
+        endResetModel ();
+        if (m_rows.count () != oldCount) {
+            emit countChanged ();
+        }
+    }
+
+protected: // internal stuff
+    struct Entry {
+        explicit Entry (const SortKey & k = SortKey (), ItemType * i = Q_NULLPTR) : key (k), item (i) { }
+        SortKey    key;
+        ItemType * item;
+    };
+    struct LessThan {
+        explicit LessThan (Qt::SortOrder o) : order (o) { }
+        bool operator() (const Entry & left, const Entry & right) const {
+            const SortKey & first  = (order == Qt::AscendingOrder ? left.key  : right.key);
+            const SortKey & second = (order == Qt::AscendingOrder ? right.key : left.key);
+            if (first < second) {
+                return true;
+            }
+            if (second < first) {
+                return false;
+            }
+            return std::less<ItemType *> () (left.item, right.item);
+        }
+        Qt::SortOrder order;
+    };
+    static const QModelIndex & noParent (void) {
+        static const QModelIndex ret = QModelIndex ();
+        return ret;
+    }
+    bool accepts (ItemType * item) const {
+        return (item != Q_NULLPTR && (!m_filter || m_filter (item)));
+    }
+    int lowerBound (const Entry & entry) const {
+        return int (std::lower_bound (m_rows.constBegin (), m_rows.constEnd (), entry, LessThan (m_order)) - m_rows.constBegin ());
+    }
+    void insertItem (ItemType * item) {
+        if (accepts (item) && !m_keyByItem.contains (item)) {
+            const Entry entry (m_key (item), item);
+            const int row = lowerBound (entry);
+            beginInsertRows (noParent (), row, row);
+            m_rows.insert (row, entry);
+            m_keyByItem.insert (item, entry.key);
+            endInsertRows ();
+            emit countChanged ();
+        }
+    }
+    void removeItem (ItemType * item) {
+        const int row = indexOf (item);
+        if (row >= 0 && row < m_rows.count () && m_rows.at (row).item == item) {
+            beginRemoveRows (noParent (), row, row);
+            m_rows.remove (row);
+            m_keyByItem.remove (item);
+            endRemoveRows ();
+            emit countChanged ();
+        }
+    }
+    void updateItem (ItemType * item) {
+        if (item != Q_NULLPTR) {
+            if (!accepts (item)) {
+                removeItem (item);
+            }
+            else if (!m_keyByItem.contains (item)) {
+                insertItem (item);
+            }
+            else {
+                const int from = indexOf (item);
+                const Entry entry (m_key (item), item);
+                const int to = lowerBound (entry); // NOTE : computed with the old entry still in place
+                int row = from;
+                if (to != from && to != from +1 && beginMoveRows (noParent (), from, from, noParent (), to)) {
+                    row = (to > from ? to -1 : to);
+                    m_rows.remove (from);
+                    m_rows.insert (row, entry);
+                    m_keyByItem.insert (item, entry.key);
+                    endMoveRows ();
+                }
+                else {
+                    m_rows [from] = entry;
+                    m_keyByItem.insert (item, entry.key);
+                }
+                const QModelIndex index = QAbstractListModel::index (row, 0, noParent ());
+                emit dataChanged (index, index);
+            }
+        }
+    }
+
+private: // data members
+    Qt::SortOrder                   m_order;
+    KeyAccessor                     m_key;
+    Filter                          m_filter;
+    QQmlObjectListModel<ItemType> * m_source;
+    QVector<Entry>                  m_rows;
+    QHash<ItemType *, SortKey>      m_keyByItem;
+};
+
+#endif // QQMLSORTFILTEROBJECTLISTMODEL_H